@@ -4,8 +4,44 @@
 #include <cstring>
 #include <iomanip>
 #include <limits>
+#include <cstdio>
+#include <climits>
+#include <algorithm>
+#include <chrono>
 #include <locale.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <sstream>
+#include <cerrno>
+#ifdef _WIN32
 #include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#define SERVIDOR_EPOLL
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BUSQUEDA_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BUSQUEDA_SSE2
+#endif
 
 using namespace std;
 
@@ -18,7 +54,8 @@ struct Producto {
     int idProveedor;           // ID del proveedor asociado
     float precio;              // Precio unitario
     int stock;                 // Cantidad en inventario
-    char fechaRegistro[11];    // Formato: YYYY-MM-DD
+    int fechaRegistro;         // Das desde 1970-01-01 (ver formatearFecha)
+    int stockMinimo;           // Por debajo hay que reponer (0 = sin aviso)
 };
 
 //1.2 Estructura Proveedor
@@ -30,7 +67,7 @@ struct Proveedor {
     char telefono[20];         // Telfono de contacto
     char email[100];           // Correo electrnico
     char direccion[200];       // Direccin fsica
-    char fechaRegistro[11];    // Formato: YYYY-MM-DD
+    int fechaRegistro;         // Das desde 1970-01-01 (ver formatearFecha)
 };
 
 //1.3 Estructura Cliente
@@ -42,7 +79,7 @@ struct Cliente {
     char telefono[20];         // Telfono de contacto
     char email[100];           // Correo electrnico
     char direccion[200];       // Direccin fsica
-    char fechaRegistro[11];    // Formato: YYYY-MM-DD
+    int fechaRegistro;         // Das desde 1970-01-01 (ver formatearFecha)
 };
 
 //1.4 Estructura Transaccin (CASO ESPECIAL: Esta estructura puede separarse como se coment en clase, tienen libertad de hacerlo.)
@@ -55,1546 +92,8707 @@ struct Transaccion {
     int cantidad;              // Cantidad de unidades
     float precioUnitario;      // Precio por unidad en esta transaccin
     float total;               // cantidad * precioUnitario
-    char fecha[11];            // Formato: YYYY-MM-DD
+    int fecha;                 // Das desde 1970-01-01 (ver formatearFecha)
     char descripcion[200];     // Notas adicionales (opcional)
 };
 
+//Almacenamiento por segmentos
+
+// Array repartido en segmentos de TAM_SEGMENTO elementos. Crecer agrega un
+// segmento nuevo y nunca mueve los registros existentes, as que sus
+// direcciones no cambian. Un segmento puede salir de new[] o apuntar dentro de
+// un snapshot mapeado.
+const int BITS_SEGMENTO = 12;
+const int TAM_SEGMENTO = 1 << BITS_SEGMENTO;
+
+template <typename T>
+struct ArregloSegmentado {
+    T** segmentos;
+    int numSegmentos;
+    int capacidadTabla;        // lugares en 'segmentos'
+
+    T& operator[](int i) { return segmentos[i >> BITS_SEGMENTO][i & (TAM_SEGMENTO - 1)]; }
+    const T& operator[](int i) const { return segmentos[i >> BITS_SEGMENTO][i & (TAM_SEGMENTO - 1)]; }
+};
+
 //1.5 Estructura Principal: Tienda
 
+struct RegistroCambios;
+
+// ndice directo id -> posicin en el array. Los ids salen de los contadores
+// siguienteId*, as que una tabla densa indexada por id basta.
+struct IndiceId {
+    int* posiciones;           // -1 si el id no existe
+    int capacidad;
+    bool construido;           // se arma con la primera bsqueda
+};
+
+// ndice hash de una clave nica de texto (cdigo, RIF, cdula) -> id
+const int LARGO_CLAVE = 20;
+
+struct EntradaClave {
+    char clave[LARGO_CLAVE];
+    int id;                    // 0 = libre
+};
+
+struct IndiceClave {
+    EntradaClave* entradas;
+    int capacidad;             // siempre potencia de 2
+    int num;
+    bool construido;
+};
+
+// ndice invertido de trigramas (en minsculas) -> ids que lo contienen
+struct ListaIds {
+    int* ids;                  // ordenados de menor a mayor
+    int num;
+    int capacidad;
+};
+
+struct EntradaTrigrama {
+    unsigned int clave;        // 3 bytes del trigrama; 0 = libre
+    ListaIds lista;
+};
+
+struct IndiceTrigramas {
+    EntradaTrigrama* entradas;
+    int capacidad;             // siempre potencia de 2
+    int num;
+    int obsoletos;             // ids que quedaron tras modificar o borrar
+    bool construido;
+};
+
+// Copia por columnas de los campos numricos de los productos. Las bsquedas
+// por stock o precio recorren estos arrays contiguos en lugar de arrastrar
+// por la cach los ~350 bytes de cada Producto. La posicin i de cada columna
+// corresponde a tienda->productos[i].
+struct ColumnasProductos {
+    int* ids;                  // negativo en las lpidas, como en el registro
+    int* idsProveedor;
+    float* precios;
+    int* stocks;
+    int capacidad;
+    bool construido;
+};
+
+// Ids de cada da, para consultas por rango de fechas
+struct IndiceFechas {
+    ListaIds* dias;            // dias[fecha - primerDia]
+    int primerDia;
+    int numDias;
+    bool construido;
+};
+
+// Totales de un conjunto de productos activos. El valor va en centavos para
+// que sumar y restar el mismo producto deje el total exactamente igual.
+struct TotalesInventario {
+    int productos;
+    long long unidades;        // Suma de stock
+    long long valorCentavos;   // Suma de precio * stock
+};
+
+// Totales de todo el inventario y de cada proveedor, al da con cada cambio
+struct AgregadosInventario {
+    TotalesInventario global;
+    TotalesInventario* porProveedor;   // porProveedor[idProveedor]
+    int capacidad;
+    bool construido;
+};
+
+// Productos con stock mnimo en montculos por holgura (stock - mnimo)
+struct EntradaReposicion {
+    int holgura;
+    int id;
+    int idProveedor;
+};
+
+struct MonticuloReposicion {
+    EntradaReposicion* entradas;
+    int num;
+    int capacidad;
+};
+
+struct IndiceReposicion {
+    MonticuloReposicion todos;
+    MonticuloReposicion* porProveedor;     // porProveedor[idProveedor]
+    int capacidadProveedores;
+    int* posiciones;           // posiciones[id] en 'todos', -1 si no est
+    int* posicionesProveedor;  // posicin de cada id en el de su proveedor
+    int capacidadPosiciones;
+    bool construido;
+};
+
+// Orden de un listado; los ndices de orden existen para los campos desde
+// ORDEN_NOMBRE (en proveedores y clientes, solo ese)
+enum CampoOrden {
+    ORDEN_REGISTRO,            // orden de alta, sin ndice
+    ORDEN_NOMBRE,
+    ORDEN_PRECIO,
+    ORDEN_STOCK,
+    ORDEN_FECHA
+};
+
+const int NUM_ORDENES_PRODUCTO = ORDEN_FECHA - ORDEN_NOMBRE + 1;
+const int TODOS_LOS_ORDENES = (1 << ORDEN_NOMBRE) | (1 << ORDEN_PRECIO) | (1 << ORDEN_STOCK) | (1 << ORDEN_FECHA);
+
+struct ClaveOrden {
+    unsigned long long clave;
+    int id;
+    const char* texto;         // solo en los ndices por nombre
+};
+
+struct NodoOrden {
+    unsigned long long clave;
+    int id;
+    int izq, der;              // 0 = vaco
+    int tam;                   // nodos del subrbol
+    unsigned int prioridad;
+};
+
+struct IndiceOrden {
+    NodoOrden* nodos;          // nodos[0] es el vaco
+    int raiz;
+    int usados;
+    int capacidad;
+    int libre;                 // nodos liberados, encadenados por izq
+    unsigned int semilla;
+    bool porTexto;             // la clave es un prefijo de 'nombre'
+    bool construido;
+};
+
+// Lneas, unidades y monto (en centavos) de un grupo de transacciones
+struct Movimiento {
+    int lineas;
+    long long unidades;
+    long long centavos;
+};
+
+struct TotalesDia {
+    Movimiento ventas;
+    Movimiento compras;
+};
+
+// Copia por columnas de las transacciones para los reportes de ventas, ms
+// los totales de cada da. La posicin i de cada columna corresponde a
+// tienda->transacciones[i].
+struct ColumnasTransacciones {
+    int* fechas;
+    unsigned char* esVenta;    // 1 venta, 0 compra
+    int* idsProducto;
+    int* idsRelacionado;
+    int* cantidades;
+    long long* centavos;       // total de la lnea
+    int num;
+    int capacidad;
+    bool ordenadas;            // fechas no decrecientes (lo normal: se asientan hoy)
+    TotalesDia* dias;          // dias[fecha - primerDia]
+    int primerDia;
+    int numDias;
+    bool construido;
+};
+
+// ndice inverso id de proveedor -> ids de sus productos
+struct IndiceProveedorProductos {
+    ListaIds* listas;          // listas[idProveedor]
+    int capacidad;
+    bool construido;
+};
+
+// Tabla de registros de una entidad: almacenamiento por segmentos, lpidas e
+// ndice por id. Todas las entidades la usan, as que el crecimiento, la
+// compactacin y la bsqueda por id se escriben una sola vez.
+template <typename T>
+struct Tabla {
+    ArregloSegmentado<T> registros;
+    int num;                   // posiciones usadas, incluidas las lpidas
+    int capacidad;
+    int eliminados;            // lpidas pendientes de compactar
+    int* eliminadosPorSegmento; // lpidas de cada segmento (nullptr = ninguna)
+    int segmentosContados;     // largo de eliminadosPorSegmento
+    IndiceId indice;           // id -> posicin
+
+    T& operator[](int i) { return registros[i]; }
+    const T& operator[](int i) const { return registros[i]; }
+};
+
 struct Tienda {
     char nombre[100];          // Nombre de la tienda
     char rif[20];              // RIF de la tienda
     
-    // Arrays dinmicos de entidades
-    Producto* productos;
-    int numProductos;
-    int capacidadProductos;
-    
-    Proveedor* proveedores;
-    int numProveedores;
-    int capacidadProveedores;
-    
-    Cliente* clientes;
-    int numClientes;
-    int capacidadClientes;
-    
-    Transaccion* transacciones;
-    int numTransacciones;
-    int capacidadTransacciones;
+    // Tablas de entidades
+    Tabla<Producto> productos;
+    Tabla<Proveedor> proveedores;
+    Tabla<Cliente> clientes;
+    Tabla<Transaccion> transacciones;
     
     // Contadores para IDs autoincrementales
     int siguienteIdProducto;
     int siguienteIdProveedor;
     int siguienteIdCliente;
     int siguienteIdTransaccion;
+
+    // ndices de claves nicas
+    IndiceClave indiceCodigos;
+    IndiceClave indiceRifs;
+    IndiceClave indiceCedulas;
+
+    // ndices de trigramas para bsquedas parciales
+    IndiceTrigramas trigramasNombreProducto;
+    IndiceTrigramas trigramasCodigoProducto;
+    IndiceTrigramas trigramasNombreProveedor;
+    IndiceTrigramas trigramasNombreCliente;
+
+    // Productos de cada proveedor
+    IndiceProveedorProductos productosPorProveedor;
+
+    // Campos calientes de productos por columnas
+    ColumnasProductos columnasProductos;
+
+    // Fechas de registro de productos y fechas de transacciones, ordenadas
+    IndiceFechas fechasProductos;
+    IndiceFechas fechasTransacciones;
+
+    // Totales de inventario
+    AgregadosInventario agregados;
+
+    // Productos por reponer, el ms urgente primero
+    IndiceReposicion reposicion;
+
+    // ndices de orden para listar por pginas
+    IndiceOrden ordenProductos[NUM_ORDENES_PRODUCTO];  // por CampoOrden desde ORDEN_NOMBRE
+    IndiceOrden ordenProveedores;
+    IndiceOrden ordenClientes;
+
+    // Transacciones por columnas y totales diarios para los reportes
+    ColumnasTransacciones columnasTransacciones;
+
+    // Snapshot mapeado en memoria (nullptr si todo vive en el heap)
+    char* vistaSnapshot;
+    long long tamVistaSnapshot;
+
+    // Registro de cambios (nullptr mientras se recupera o si no hay WAL)
+    RegistroCambios* wal;
+    long long lsn;             // ltimo cambio aplicado
 };
 
 //==============
 //verificaciones y utilidades
 //==============
 
-string toLower(const char* s) {
-    string r = s;
-    for (char& c : r) c = tolower(c);
-    return r;
-}
+// Un registro eliminado queda como lpida con el id en negativo hasta que se
+// compacta su tabla
+bool activo(const Producto& p) { return p.id > 0; }
+bool activo(const Proveedor& p) { return p.id > 0; }
+bool activo(const Cliente& c) { return c.id > 0; }
+bool activo(const Transaccion& t) { return t.id > 0; }
 
 void convertirAMinusculas(char* cadena) {
     for (int i = 0; cadena[i]; i++)
         cadena[i] = tolower(cadena[i]);
 }
 
-bool contiene(const char* campo, const string& filtro) {
-    string a = toLower(campo);
-    return a.find(filtro) != string::npos;
+//==============
+//bsqueda de texto sin distinguir maysculas
+//==============
+
+// Los campos de texto son arrays de tamao fijo, as que se recorren de a 16
+// (SSE2) o 32 (AVX2) bytes sin salirse del array y sin copiar nada. Se
+// pliega como tolower en Latin-1: A-Z y - (salvo ) pasan a minsculas.
+
+const int MAX_PATRON = 200;
+
+struct PatronTexto {
+    unsigned char texto[MAX_PATRON];   // Ya plegado; sin terminador
+    int len;
+    unsigned char primeroAlt;          // Mayscula del primer carcter (o l mismo)
+    unsigned char ultimoAlt;           // dem del ltimo
+};
+
+inline unsigned char plegarCaracter(unsigned char c) {
+    bool mayuscula = (c >= 'A' && c <= 'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7);
+    return mayuscula ? (unsigned char)(c | 0x20) : c;
+}
+
+// El otro carcter que se pliega a 'c', si lo hay
+unsigned char mayusculaDe(unsigned char c) {
+    unsigned char otro = (unsigned char)(c ^ 0x20);
+    return otro != c && plegarCaracter(otro) == c ? otro : c;
 }
-bool existeProveedor(Tienda* tienda, int idProveedor) {
-    for (int i = 0; i < tienda->numProveedores; i++) {
-        if (tienda->proveedores[i].id == idProveedor)
-            return true;
+
+void prepararPatron(PatronTexto* p, const char* patron) {
+    p->len = (int)strlen(patron);
+    for (int i = 0; i < p->len && i < MAX_PATRON; i++)
+        p->texto[i] = plegarCaracter((unsigned char)patron[i]);
+    if (p->len > 0 && p->len < MAX_PATRON) {
+        p->primeroAlt = mayusculaDe(p->texto[0]);
+        p->ultimoAlt = mayusculaDe(p->texto[p->len - 1]);
     }
-    return false;
 }
 
-bool codigoProductoDuplicado(Tienda* tienda, const char* codigo, int idIgnorar = -1) {
-    for (int i = 0; i < tienda->numProductos; i++) {
-        if (tienda->productos[i].id == idIgnorar) continue;
-        if (strcmp(tienda->productos[i].codigo, codigo) == 0)
+bool igualesPlegados(const unsigned char* campo, const unsigned char* patron, int len) {
+    for (int i = 0; i < len; i++) {
+        if (plegarCaracter(campo[i]) != patron[i])
+            return false;
+    }
+    return true;
+}
+
+inline int primerBit(unsigned int mascara) {
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanForward(&bit, mascara);
+    return (int)bit;
+#else
+    return __builtin_ctz(mascara);
+#endif
+}
+
+// El texto de 'campo' (un array de 'tamCampo' bytes) contiene el patrn?
+// Por bloque se buscan a la vez todas las posiciones donde coinciden el
+// primer y el ltimo carcter del patrn (en cualquiera de sus dos formas),
+// y solo esas se comparan enteras.
+// El largo del texto no se mide aparte: el mismo bloque dice dnde est el
+// '\0', y una coincidencia nunca puede cruzarlo porque el patrn no lo tiene.
+bool contieneTexto(const char* campo, int tamCampo, const PatronTexto* p) {
+    int m = p->len;
+    if (m == 0) return true;
+    if (m >= tamCampo) return false;
+
+    const unsigned char* c = (const unsigned char*)campo;
+    int i = 0;
+
+#ifdef BUSQUEDA_AVX2
+    {
+        __m256i primero = _mm256_set1_epi8((char)p->texto[0]);
+        __m256i primeroAlt = _mm256_set1_epi8((char)p->primeroAlt);
+        __m256i final = _mm256_set1_epi8((char)p->texto[m - 1]);
+        __m256i finalAlt = _mm256_set1_epi8((char)p->ultimoAlt);
+        for (; i + m - 1 + 32 <= tamCampo; i += 32) {
+            __m256i bloque = _mm256_loadu_si256((const __m256i*)(c + i));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(c + i + m - 1));
+            __m256i enPrimero = _mm256_or_si256(_mm256_cmpeq_epi8(bloque, primero),
+                                                _mm256_cmpeq_epi8(bloque, primeroAlt));
+            __m256i enFinal = _mm256_or_si256(_mm256_cmpeq_epi8(b, final),
+                                              _mm256_cmpeq_epi8(b, finalAlt));
+            unsigned int mascara = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(enPrimero, enFinal));
+            unsigned int ceros = (unsigned int)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(bloque, _mm256_setzero_si256()));
+            if (ceros != 0) mascara &= (1u << primerBit(ceros)) - 1;
+            while (mascara != 0) {
+                int k = i + primerBit(mascara);
+                if (m <= 2 || igualesPlegados(c + k + 1, p->texto + 1, m - 2))
+                    return true;
+                mascara &= mascara - 1;
+            }
+            if (ceros != 0) return false;
+        }
+    }
+#endif
+#ifdef BUSQUEDA_SSE2
+    {
+        __m128i primero = _mm_set1_epi8((char)p->texto[0]);
+        __m128i primeroAlt = _mm_set1_epi8((char)p->primeroAlt);
+        __m128i final = _mm_set1_epi8((char)p->texto[m - 1]);
+        __m128i finalAlt = _mm_set1_epi8((char)p->ultimoAlt);
+        for (; i + m - 1 + 16 <= tamCampo; i += 16) {
+            __m128i bloque = _mm_loadu_si128((const __m128i*)(c + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(c + i + m - 1));
+            __m128i enPrimero = _mm_or_si128(_mm_cmpeq_epi8(bloque, primero),
+                                             _mm_cmpeq_epi8(bloque, primeroAlt));
+            __m128i enFinal = _mm_or_si128(_mm_cmpeq_epi8(b, final),
+                                           _mm_cmpeq_epi8(b, finalAlt));
+            unsigned int mascara = (unsigned int)_mm_movemask_epi8(_mm_and_si128(enPrimero, enFinal));
+            unsigned int ceros = (unsigned int)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(bloque, _mm_setzero_si128()));
+            if (ceros != 0) mascara &= (1u << primerBit(ceros)) - 1;
+            while (mascara != 0) {
+                int k = i + primerBit(mascara);
+                if (m <= 2 || igualesPlegados(c + k + 1, p->texto + 1, m - 2))
+                    return true;
+                mascara &= mascara - 1;
+            }
+            if (ceros != 0) return false;
+        }
+    }
+#endif
+
+    // Lo que queda (o todo, sin SIMD) byte a byte
+    for (; i + m <= tamCampo && c[i] != '\0'; i++) {
+        if (plegarCaracter(c[i]) == p->texto[0] && igualesPlegados(c + i + 1, p->texto + 1, m - 1))
             return true;
     }
     return false;
 }
+//==============
+//fechas
+//==============
+
+// Las fechas se guardan como das desde 1970-01-01 (calendario gregoriano) y
+// solo se pasan a texto para mostrarlas o exportarlas
+const int LARGO_FECHA = 11;    // "YYYY-MM-DD" + '\0'
+
+int diasDesdeEpoca(int anio, int mes, int dia) {
+    // Aos contados desde marzo, para que el 29 de febrero quede al final
+    anio -= mes <= 2;
+    int era = (anio >= 0 ? anio : anio - 399) / 400;
+    int anioEra = anio - era * 400;
+    int diaAnio = (153 * (mes > 2 ? mes - 3 : mes + 9) + 2) / 5 + dia - 1;
+    int diaEra = anioEra * 365 + anioEra / 4 - anioEra / 100 + diaAnio;
+    return era * 146097 + diaEra - 719468;
+}
 
-void obtenerFechaActual(char* buffer) {
-    time_t t = time(nullptr);
-    tm* fecha = localtime(&t);
-    sprintf(buffer, "%04d-%02d-%02d",
-            fecha->tm_year + 1900,
-            fecha->tm_mon + 1,
-            fecha->tm_mday);
+void fechaDesdeDias(int dias, int* anio, int* mes, int* dia) {
+    dias += 719468;
+    int era = (dias >= 0 ? dias : dias - 146096) / 146097;
+    int diaEra = dias - era * 146097;
+    int anioEra = (diaEra - diaEra / 1460 + diaEra / 36524 - diaEra / 146096) / 365;
+    int diaAnio = diaEra - (365 * anioEra + anioEra / 4 - anioEra / 100);
+    int mesMarzo = (5 * diaAnio + 2) / 153;
+    *dia = diaAnio - (153 * mesMarzo + 2) / 5 + 1;
+    *mes = mesMarzo < 10 ? mesMarzo + 3 : mesMarzo - 9;
+    *anio = anioEra + era * 400 + (*mes <= 2);
 }
 
-bool validarFecha(const char* fecha) {
-    if (strlen(fecha) != 10) return false;
-    if (fecha[4] != '-' || fecha[7] != '-') return false;
+// Escribe "YYYY-MM-DD" en 'buffer' (al menos LARGO_FECHA bytes)
+void formatearFecha(int dias, char* buffer) {
+    int anio, mes, dia;
+    fechaDesdeDias(dias, &anio, &mes, &dia);
+    if (anio < 0 || anio > 9999) {
+        strcpy(buffer, "----------");
+        return;
+    }
+    buffer[0] = '0' + anio / 1000;
+    buffer[1] = '0' + anio / 100 % 10;
+    buffer[2] = '0' + anio / 10 % 10;
+    buffer[3] = '0' + anio % 10;
+    buffer[4] = '-';
+    buffer[5] = '0' + mes / 10;
+    buffer[6] = '0' + mes % 10;
+    buffer[7] = '-';
+    buffer[8] = '0' + dia / 10;
+    buffer[9] = '0' + dia % 10;
+    buffer[10] = '\0';
+}
+
+int diasDelMes(int anio, int mes) {
+    static const int dias[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool bisiesto = (anio % 4 == 0 && anio % 100 != 0) || anio % 400 == 0;
+    return mes == 2 && bisiesto ? 29 : dias[mes - 1];
+}
 
-    int anio = atoi(fecha);
-    int mes = atoi(fecha + 5);
-    int dia = atoi(fecha + 8);
+// Lee "YYYY-MM-DD" entre 1900 y 2100. Devuelve false si el formato o la
+// fecha no son vlidos (incluye das que el mes no tiene).
+bool parsearFecha(const char* texto, int* dias) {
+    for (int i = 0; i < 10; i++) {
+        bool guion = i == 4 || i == 7;
+        if (guion ? texto[i] != '-' : !isdigit((unsigned char)texto[i]))
+            return false;
+    }
+    if (texto[10] != '\0') return false;
+
+    int anio = (texto[0] - '0') * 1000 + (texto[1] - '0') * 100 + (texto[2] - '0') * 10 + (texto[3] - '0');
+    int mes = (texto[5] - '0') * 10 + (texto[6] - '0');
+    int dia = (texto[8] - '0') * 10 + (texto[9] - '0');
 
     if (anio < 1900 || anio > 2100) return false;
     if (mes < 1 || mes > 12) return false;
-    if (dia < 1 || dia > 31) return false;
+    if (dia < 1 || dia > diasDelMes(anio, mes)) return false;
 
+    *dias = diasDesdeEpoca(anio, mes, dia);
     return true;
 }
 
-const char* obtenerNombreProveedor(Tienda* tienda, int idProveedor) {
-    for (int i = 0; i < tienda->numProveedores; i++) {
-        if (tienda->proveedores[i].id == idProveedor)
-            return tienda->proveedores[i].nombre;
+// Fecha local de hoy. localtime solo se consulta cuando cambia el da.
+int fechaActual() {
+    static int hoy = 0;
+    static time_t finDelDia = 0;
+
+    time_t ahora = time(nullptr);
+    if (ahora >= finDelDia) {
+        tm local = *localtime(&ahora);
+        hoy = diasDesdeEpoca(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+
+        // Medianoche siguiente; mktime normaliza la hora 24
+        local.tm_hour = 24;
+        local.tm_min = 0;
+        local.tm_sec = 0;
+        local.tm_isdst = -1;
+        finDelDia = mktime(&local);
     }
-    return "Desconocido";
+    return hoy;
 }
 
-void solicitarString(const char* mensaje, char* destino, int maxLen,
-                     bool (*validador)(const char*) = nullptr,
-                     const char* mensajeError = "ERROR: Valor invlido.\n") 
-{
-    while (true) {
-        cout << mensaje;
-        cin.getline(destino, maxLen);
+//==============
+//ndices por id
+//==============
 
-        if (strlen(destino) == 0) {
-            cout << "ERROR: No puede estar vaco.\n";
-            continue;
-        }
+void iniciarIndiceId(IndiceId* indice) {
+    indice->posiciones = nullptr;
+    indice->capacidad = 0;
+    indice->construido = false;
+}
 
-        if (validador != nullptr && !validador(destino)) {
-            cout << mensajeError;
-            continue;
-        }
+void liberarIndiceId(IndiceId* indice) {
+    delete[] indice->posiciones;
+    iniciarIndiceId(indice);
+}
 
-        break;
+void asignarEnIndiceId(IndiceId* indice, int id, int posicion) {
+    if (id <= 0) return;
+
+    if (id >= indice->capacidad) {
+        int nuevaCap = max(indice->capacidad * 2, 16);
+        while (nuevaCap <= id) nuevaCap *= 2;
+
+        int* nuevo = new int[nuevaCap];
+        for (int i = 0; i < indice->capacidad; i++)
+            nuevo[i] = indice->posiciones[i];
+        for (int i = indice->capacidad; i < nuevaCap; i++)
+            nuevo[i] = -1;
+
+        delete[] indice->posiciones;
+        indice->posiciones = nuevo;
+        indice->capacidad = nuevaCap;
     }
+
+    indice->posiciones[id] = posicion;
 }
 
-bool sinEspacios(const char* texto) {
-    for (int i = 0; texto[i] != '\0'; i++)
-        if (texto[i] == ' ')
-            return false;
-    return true;
+int posicionEnIndiceId(const IndiceId* indice, int id) {
+    if (id <= 0 || id >= indice->capacidad) return -1;
+    return indice->posiciones[id];
 }
 
 
-bool emailValido(const char* email) {
-    const char* at = strchr(email, '@');
-    if (!at) return false;
+//==============
+//tablas de entidades
+//==============
 
-    const char* punto = strchr(at, '.');
-    if (!punto) return false;
+bool enVistaSnapshot(Tienda* tienda, const void* ptr);
 
-    return true;
+template <typename T>
+void iniciarSegmentos(ArregloSegmentado<T>* a) {
+    a->segmentos = nullptr;
+    a->numSegmentos = 0;
+    a->capacidadTabla = 0;
 }
 
-bool rifDuplicado(Tienda* tienda, const char* rif, int idIgnorar = -1) {
-    for (int i = 0; i < tienda->numProveedores; i++) {
-        if (tienda->proveedores[i].id == idIgnorar) continue;
-        if (strcmp(tienda->proveedores[i].rif, rif) == 0)
-            return true;
+// Solo crece la tabla de punteros; los segmentos no se tocan
+template <typename T>
+void agregarSegmento(ArregloSegmentado<T>* a, T* segmento) {
+    if (a->numSegmentos >= a->capacidadTabla) {
+        int nuevaCap = max(a->capacidadTabla * 2, 8);
+        T** nueva = new T*[nuevaCap];
+        for (int i = 0; i < a->numSegmentos; i++)
+            nueva[i] = a->segmentos[i];
+        delete[] a->segmentos;
+        a->segmentos = nueva;
+        a->capacidadTabla = nuevaCap;
     }
-    return false;
+    a->segmentos[a->numSegmentos++] = segmento;
 }
 
-bool clienteDuplicado(Tienda* tienda, const char* cedula, int idIgnorar = -1) {
-    for (int i = 0; i < tienda->numClientes; i++) {
-        if (tienda->clientes[i].id == idIgnorar) continue;
-        if (strcmp(tienda->clientes[i].cedula, cedula) == 0)
-            return true;
+// Garantiza espacio para al menos 'minimo' elementos agregando segmentos
+template <typename T>
+void reservarSegmentos(ArregloSegmentado<T>* a, int* capacidad, int minimo) {
+    while (*capacidad < minimo) {
+        agregarSegmento(a, new T[TAM_SEGMENTO]);
+        *capacidad += TAM_SEGMENTO;
     }
-    return false;
 }
 
-bool confirmar(const char* mensaje) {
-    char op[10];
-    cout << mensaje;
-    cin >> op;
-    cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // <- clave
-
-    return toupper(op[0]) == 'S';
+// Los segmentos dentro del snapshot mapeado no se liberan con delete[]
+template <typename T>
+void liberarSegmentos(Tienda* tienda, ArregloSegmentado<T>* a) {
+    for (int i = 0; i < a->numSegmentos; i++) {
+        if (!enVistaSnapshot(tienda, a->segmentos[i]))
+            delete[] a->segmentos[i];
+    }
+    delete[] a->segmentos;
+    iniciarSegmentos(a);
 }
 
-
-int solicitarEnteroPositivo(const char* mensaje) {
-    int valor;
-    cout << mensaje;
-    cin >> valor;
-
-    while (valor <= 0) {
-        cout << "ERROR: Debe ser mayor a 0.\n";
-        cout << mensaje;
-        cin >> valor;
+// Arma los segmentos sobre 'num' registros contiguos de un snapshot mapeado.
+// Los segmentos completos apuntan al mapeo; el ltimo, si queda a medias, se
+// copia al heap para poder seguir llenndolo.
+template <typename T>
+void mapearSegmentos(ArregloSegmentado<T>* a, int* capacidad, T* base, int num) {
+    iniciarSegmentos(a);
+    *capacidad = 0;
+
+    int completos = num / TAM_SEGMENTO;
+    for (int i = 0; i < completos; i++)
+        agregarSegmento(a, base + (long long)i * TAM_SEGMENTO);
+
+    int resto = num - completos * TAM_SEGMENTO;
+    if (resto > 0) {
+        T* ultimo = new T[TAM_SEGMENTO];
+        memcpy(ultimo, base + (long long)completos * TAM_SEGMENTO, resto * sizeof(T));
+        agregarSegmento(a, ultimo);
     }
-    return valor;
+
+    *capacidad = a->numSegmentos * TAM_SEGMENTO;
 }
-int solicitarEnteroNoNegativo(const char* mensaje) {
-    int valor;
-    cout << mensaje;
-    cin >> valor;
 
-    while (valor < 0) {
-        cout << "ERROR: Debe ser >= 0.\n";
-        cout << mensaje;
-        cin >> valor;
+// Copia al heap los segmentos que apuntan al snapshot mapeado
+template <typename T>
+void desvincularSegmentos(Tienda* tienda, ArregloSegmentado<T>* a) {
+    for (int i = 0; i < a->numSegmentos; i++) {
+        if (!enVistaSnapshot(tienda, a->segmentos[i])) continue;
+        T* copia = new T[TAM_SEGMENTO];
+        memcpy(copia, a->segmentos[i], TAM_SEGMENTO * sizeof(T));
+        a->segmentos[i] = copia;
     }
-    return valor;
 }
 
-
-int buscarProductoPorID(Tienda* tienda, int id) {
-    for (int i = 0; i < tienda->numProductos; i++)
-        if (tienda->productos[i].id == id)
-            return i;
-    return -1;
+template <typename T>
+void iniciarTabla(Tabla<T>* t) {
+    iniciarSegmentos(&t->registros);
+    t->num = 0;
+    t->capacidad = 0;
+    t->eliminados = 0;
+    t->eliminadosPorSegmento = nullptr;
+    t->segmentosContados = 0;
+    iniciarIndiceId(&t->indice);
 }
 
-bool existeProducto(Tienda* tienda, int id) {
-    return buscarProductoPorID(tienda, id) != -1;
+template <typename T>
+void liberarTabla(Tienda* tienda, Tabla<T>* t) {
+    liberarSegmentos(tienda, &t->registros);
+    delete[] t->eliminadosPorSegmento;
+    liberarIndiceId(&t->indice);
+    iniciarTabla(t);
 }
 
-int* buscarProductosPorNombre(Tienda* tienda, const char* nombre, int* numResultados) {
-    *numResultados = 0;
-
-    // Primera pasada: contar coincidencias
-    for (int i = 0; i < tienda->numProductos; i++) {
-        if (strstr(tienda->productos[i].nombre, nombre) != nullptr)
-            (*numResultados)++;
-    }
-
-    if (*numResultados == 0)
-        return nullptr;
+// Usa en el sitio 'num' registros contiguos de un snapshot mapeado
+template <typename T>
+void mapearTabla(Tabla<T>* t, T* base, int num) {
+    mapearSegmentos(&t->registros, &t->capacidad, base, num);
+    t->num = num;
+    t->eliminados = 0;
+    t->eliminadosPorSegmento = nullptr;
+    t->segmentosContados = 0;
+    iniciarIndiceId(&t->indice);
+}
 
-    // Crear array dinmico
-    int* resultados = new int[*numResultados];
-    int pos = 0;
+// Garantiza lugar para al menos 'minimo' registros; las altas masivas lo
+// piden de una vez
+template <typename T>
+void reservarTabla(Tabla<T>* t, int minimo) {
+    reservarSegmentos(&t->registros, &t->capacidad, minimo);
+}
 
-    // Segunda pasada: guardar ndices
-    for (int i = 0; i < tienda->numProductos; i++) {
-        if (strstr(tienda->productos[i].nombre, nombre) != nullptr)
-            resultados[pos++] = i;
-    }
+template <typename T>
+int activosEnTabla(const Tabla<T>& t) {
+    return t.num - t.eliminados;
+}
 
-    return resultados;
+// Arma el ndice por id recorriendo la tabla una vez. Se hace en la primera
+// bsqueda y no al cargar, para no tocar todo un snapshot recin mapeado.
+// asignarEnIndiceId ignora ids <= 0, as que las lpidas no entran.
+template <typename T>
+void construirIndiceTabla(Tabla<T>* t) {
+    liberarIndiceId(&t->indice);
+    for (int i = 0; i < t->num; i++)
+        asignarEnIndiceId(&t->indice, (*t)[i].id, i);
+    t->indice.construido = true;
 }
 
-void mostrarProducto(const Producto& p) {
-    cout << "Cdigo: " << p.codigo << endl;
-    cout << "Nombre: " << p.nombre << endl;
-    cout << "Descripcin: " << p.descripcion << endl;
-    cout << "Proveedor ID: " << p.idProveedor << endl;
-    cout << "Precio: " << p.precio << endl;
-    cout << "Stock: " << p.stock << endl;
-    cout << "Fecha: " << p.fechaRegistro << endl;
+// Posicin del registro con ese id, o -1
+template <typename T>
+int posicionEnTabla(Tabla<T>* t, int id) {
+    if (!t->indice.construido)
+        construirIndiceTabla(t);
+    return posicionEnIndiceId(&t->indice, id);
 }
 
-void redimensionarProductos(Tienda* tienda) {
-    int nuevaCap = tienda->capacidadProductos * 2;
-    Producto* nuevoArray = new Producto[nuevaCap];
+// Agrega al final y devuelve la posicin. El registro se copia una sola vez,
+// directo a su lugar definitivo: los segmentos no se mueven al crecer.
+template <typename T>
+int agregarEnTabla(Tabla<T>* t, const T& registro) {
+    if (t->num >= t->capacidad)
+        reservarTabla(t, t->num + 1);
+
+    int index = t->num++;
+    (*t)[index] = registro;
+    if (t->indice.construido)
+        asignarEnIndiceId(&t->indice, registro.id, index);
+    return index;
+}
 
-    for (int i = 0; i < tienda->numProductos; i++) {
-        nuevoArray[i] = tienda->productos[i];
+// Borrado lgico: la posicin queda como lpida (id en negativo) y se
+// recupera al compactar, as borrar no depende del tamao de la tabla
+template <typename T>
+void eliminarDeTabla(Tabla<T>* t, int index) {
+    T& registro = (*t)[index];
+    int id = registro.id;
+    registro.id = -id;
+    t->eliminados++;
+
+    int segmento = index >> BITS_SEGMENTO;
+    if (segmento >= t->segmentosContados) {
+        int nuevos = t->registros.numSegmentos;
+        int* cuentas = new int[nuevos];
+        for (int i = 0; i < nuevos; i++)
+            cuentas[i] = i < t->segmentosContados ? t->eliminadosPorSegmento[i] : 0;
+        delete[] t->eliminadosPorSegmento;
+        t->eliminadosPorSegmento = cuentas;
+        t->segmentosContados = nuevos;
     }
+    t->eliminadosPorSegmento[segmento]++;
 
-    delete[] tienda->productos;
-    tienda->productos = nuevoArray;
-    tienda->capacidadProductos = nuevaCap;
+    if (t->indice.construido)
+        asignarEnIndiceId(&t->indice, id, -1);
 }
 
-void redimensionarProveedores(Tienda* tienda) {
-    int nuevaCap = tienda->capacidadProveedores * 2;
-    Proveedor* nuevoArray = new Proveedor[nuevaCap];
-
-    for (int i = 0; i < tienda->numProveedores; i++) {
-        nuevoArray[i] = tienda->proveedores[i];
+// Cierra los huecos que dejan las lpidas, conservando el orden. Devuelve
+// true si movi algo.
+template <typename T>
+bool compactarTabla(Tabla<T>* t) {
+    if (t->eliminados == 0) return false;
+
+    int destino = 0;
+    for (int i = 0; i < t->num; i++) {
+        if (!activo((*t)[i])) continue;
+        if (destino != i) {
+            (*t)[destino] = (*t)[i];
+            if (t->indice.construido)
+                asignarEnIndiceId(&t->indice, (*t)[destino].id, destino);
+        }
+        destino++;
     }
 
-    delete[] tienda->proveedores;
-    tienda->proveedores = nuevoArray;
-    tienda->capacidadProveedores = nuevaCap;
+    t->num = destino;
+    t->eliminados = 0;
+    for (int i = 0; i < t->segmentosContados; i++)
+        t->eliminadosPorSegmento[i] = 0;
+    return true;
 }
 
-void redimensionarClientes(Tienda* tienda) {
-    int nuevaCap = tienda->capacidadClientes * 2;
-    Cliente* nuevoArray = new Cliente[nuevaCap];
+// Se compacta cuando las lpidas pasan de este porcentaje de la tabla
+const int PORCENTAJE_COMPACTACION = 25;
 
-    for (int i = 0; i < tienda->numClientes; i++) {
-        nuevoArray[i] = tienda->clientes[i];
+template <typename T>
+bool necesitaCompactar(const Tabla<T>& t) {
+    return (long long)t.eliminados * 100 > (long long)t.num * PORCENTAJE_COMPACTACION;
+}
+
+// Llama a f(registro, posicion) con cada registro activo, en orden
+template <typename T, typename F>
+void paraCadaActivo(Tabla<T>& t, F f) {
+    for (int i = 0; i < t.num; i++) {
+        if (activo(t[i]))
+            f(t[i], i);
     }
+}
 
-    delete[] tienda->clientes;
-    tienda->clientes = nuevoArray;
-    tienda->capacidadClientes = nuevaCap;
+// Posicin del activo nmero 'orden' (0 = el primero), o t.num si no hay
+// tantos. Sin lpidas es directa; con lpidas se saltan segmentos enteros
+// por su cuenta de lpidas y solo se recorre aquel donde cae, as que el
+// costo es O(segmentos + TAM_SEGMENTO) y no O(num).
+template <typename T>
+int posicionDeActivo(Tabla<T>& t, int orden) {
+    if (t.eliminados == 0) return orden < t.num ? orden : t.num;
+    for (int inicio = 0, s = 0; inicio < t.num; inicio += TAM_SEGMENTO, s++) {
+        int fin = min(inicio + TAM_SEGMENTO, t.num);
+        int lapidas = s < t.segmentosContados ? t.eliminadosPorSegmento[s] : 0;
+        int activos = fin - inicio - lapidas;
+        if (orden >= activos) {
+            orden -= activos;
+            continue;
+        }
+        if (lapidas == 0) return inicio + orden;
+        for (int i = inicio; i < fin; i++) {
+            if (activo(t[i]) && orden-- == 0) return i;
+        }
+    }
+    return t.num;
 }
 
-void redimensionarTransacciones(Tienda* tienda) {
-    int nuevaCap = tienda->capacidadTransacciones * 2;
-    Transaccion* nuevoArray = new Transaccion[nuevaCap];
+// Como paraCadaActivo, pero solo 'limite' activos a partir del activo nmero
+// 'desde' (limite < 0 = hasta el final). Devuelve cuntos visit.
+template <typename T, typename F>
+int paraCadaActivoEnVentana(Tabla<T>& t, int desde, int limite, F f) {
+    int visitados = 0;
+    for (int i = posicionDeActivo(t, desde); i < t.num && visitados != limite; i++) {
+        if (!activo(t[i])) continue;
+        f(t[i], i);
+        visitados++;
+    }
+    return visitados;
+}
 
-    for (int i = 0; i < tienda->numTransacciones; i++) {
-        nuevoArray[i] = tienda->transacciones[i];
+// Posiciones (en orden) de los activos cuyo 'campo' contiene el patrn.
+// Devuelve nullptr si no hay ninguno.
+template <typename T, int N>
+int* filtrarPorTexto(Tabla<T>& t, char (T::*campo)[N], const PatronTexto* patron, int* num) {
+    int* resultados = nullptr;
+    int capacidad = 0;
+    *num = 0;
+    for (int i = 0; i < t.num; i++) {
+        const T& r = t[i];
+        if (!activo(r) || !contieneTexto(r.*campo, N, patron))
+            continue;
+        if (*num == capacidad) {
+            capacidad = max(capacidad * 2, 64);
+            int* nuevo = new int[capacidad];
+            for (int j = 0; j < *num; j++)
+                nuevo[j] = resultados[j];
+            delete[] resultados;
+            resultados = nuevo;
+        }
+        resultados[(*num)++] = i;
     }
+    return resultados;
+}
 
-    delete[] tienda->transacciones;
-    tienda->transacciones = nuevoArray;
-    tienda->capacidadTransacciones = nuevaCap;
+// Posicin del primer activo cuyo 'campo' contiene el patrn, o -1
+template <typename T, int N>
+int primeroPorTexto(Tabla<T>& t, char (T::*campo)[N], const PatronTexto* patron) {
+    for (int i = 0; i < t.num; i++) {
+        if (activo(t[i]) && contieneTexto(t[i].*campo, N, patron))
+            return i;
+    }
+    return -1;
 }
 
+//==============
+//ndices de claves nicas
+//==============
 
-//================
-//tabla producto
-//================
+// Tabla hash de direccionamiento abierto (sondeo lineal) de una clave de
+// texto corta (cdigo, RIF, cdula) al id del registro que la tiene.
 
-//linea horizontal
-void linea(const char* tipo) {
-    if (strcmp(tipo, "top") == 0)
-        cout << "+--------------------------------------------------------------------------+\n";
-    else if (strcmp(tipo, "mid") == 0)
-        cout << "--------------------------------------------------------------------------\n";
-    else if (strcmp(tipo, "sep") == 0)
-        cout << "----+-----------+------------------+--------------+-------+--------+------\n";
-    else if (strcmp(tipo, "bot") == 0)
-        cout << "+--------------------------------------------------------------------------+\n";
+unsigned int hashClave(const char* clave) {
+    unsigned int h = 2166136261u; // FNV-1a
+    for (int i = 0; clave[i] != '\0'; i++) {
+        h ^= (unsigned char)clave[i];
+        h *= 16777619u;
+    }
+    return h;
 }
 
-//encabezado
-void encabezadoProductos() {
-    linea("top");
-    cout << "                         LISTADO DE PRODUCTOS                             \n";
-    linea("mid");
-    cout << " ID   Cdigo        Nombre         Proveedor    Precio Stock   Fecha\n";
-    linea("sep");
+void iniciarIndiceClave(IndiceClave* indice) {
+    indice->entradas = nullptr;
+    indice->capacidad = 0;
+    indice->num = 0;
+    indice->construido = false;
 }
 
-//fila
-void filaProducto(const Producto& p, const char* nombreProv) {
-    cout << " "
-         << setw(2)  << left << p.id << "  "
-         << setw(9)  << left << p.codigo << "  "
-         << setw(16) << left << p.nombre << "  "
-         << setw(12) << left << nombreProv << "  "
-         << setw(5)  << left << p.precio << "  "
-         << setw(6)  << left << p.stock << "  "
-         << setw(4)  << left << p.fechaRegistro << " \n";
+void liberarIndiceClave(IndiceClave* indice) {
+    delete[] indice->entradas;
+    iniciarIndiceClave(indice);
 }
 
-void pieProductos() {
-    linea("bot");
+// Deja el ndice vaco con espacio para 'capacidadMinima' claves
+void reservarIndiceClave(IndiceClave* indice, int capacidadMinima) {
+    int cap = 16;
+    while (cap < capacidadMinima * 2) cap *= 2;
+
+    indice->entradas = new EntradaClave[cap];
+    memset(indice->entradas, 0, cap * sizeof(EntradaClave));
+    indice->capacidad = cap;
+    indice->num = 0;
 }
 
-int buscarProveedorPorID(Tienda* tienda, int id) {
-    for (int i = 0; i < tienda->numProveedores; i++) {
-        if (tienda->proveedores[i].id == id)
-            return i;
+// Devuelve el id asociado a la clave o -1 si no est
+int buscarEnIndiceClave(const IndiceClave* indice, const char* clave) {
+    int mascara = indice->capacidad - 1;
+    int pos = hashClave(clave) & mascara;
+
+    while (indice->entradas[pos].id != 0) {
+        if (strcmp(indice->entradas[pos].clave, clave) == 0)
+            return indice->entradas[pos].id;
+        pos = (pos + 1) & mascara;
     }
     return -1;
 }
 
-int buscarProveedorPorRIF(Tienda* tienda, const char* rif) {
-    for (int i = 0; i < tienda->numProveedores; i++) {
-        if (strcmp(tienda->proveedores[i].rif, rif) == 0)
-            return i;
-    }
-    return -1;
-}
+void insertarEnIndiceClave(IndiceClave* indice, const char* clave, int id);
 
-int buscarProveedorPorNombre(Tienda* tienda, const char* nombre) {
-    for (int i = 0; i < tienda->numProveedores; i++) {
-        if (strstr(tienda->proveedores[i].nombre, nombre) != nullptr)
-            return i;
+void redimensionarIndiceClave(IndiceClave* indice) {
+    EntradaClave* viejas = indice->entradas;
+    int capVieja = indice->capacidad;
+
+    reservarIndiceClave(indice, capVieja);
+    for (int i = 0; i < capVieja; i++) {
+        if (viejas[i].id != 0)
+            insertarEnIndiceClave(indice, viejas[i].clave, viejas[i].id);
     }
-    return -1;
+    delete[] viejas;
 }
 
-void mostrarProveedor(const Proveedor& p) {
-    cout << "\n=== PROVEEDOR ENCONTRADO ===\n";
-    cout << "ID: " << p.id << endl;
-    cout << "RIF: " << p.rif << endl;
-    cout << "Nombre: " << p.nombre << endl;
-    cout << "Email: " << p.email << endl;
-    cout << "Telfono: " << p.telefono << endl;
-}
+void insertarEnIndiceClave(IndiceClave* indice, const char* clave, int id) {
+    // Carga mxima del 50% para que el sondeo lineal se mantenga corto
+    if ((indice->num + 1) * 2 > indice->capacidad)
+        redimensionarIndiceClave(indice);
 
-//================
-// tabla proveedor
-//================
-void lineaProv(const char* tipo) {
-    if (strcmp(tipo, "top") == 0)
-        cout << "+--------------------------------------------------------------------------+\n";
-    else if (strcmp(tipo, "mid") == 0)
-        cout << "--------------------------------------------------------------------------\n";
-    else if (strcmp(tipo, "sep") == 0)
-        cout << "----+----------------------+------------------+---------------------------\n";
-    else if (strcmp(tipo, "bot") == 0)
-        cout << "+--------------------------------------------------------------------------+\n";
-}
-void encabezadoProveedores() {
-    lineaProv("top");
-    cout << "                         LISTADO DE PROVEEDORES                           \n";
-    lineaProv("mid");
-    cout << " ID        Nombre               RIF                Telfono           \n";
-    lineaProv("sep");
-}
-void filaProveedor(const Proveedor& p) {
-    cout << " "
-         << setw(2)  << left << p.id << "  "
-         << setw(20) << left << p.nombre << "  "
-         << setw(16) << left << p.rif << "  "
-         << setw(25) << left << p.telefono << " \n";
-}
-void pieProveedores() {
-    lineaProv("bot");
-}
+    int mascara = indice->capacidad - 1;
+    int pos = hashClave(clave) & mascara;
 
-int buscarClientePorID(Tienda* tienda, int id) {
-    for (int i = 0; i < tienda->numClientes; i++) {
-        if (tienda->clientes[i].id == id)
-            return i;
+    while (indice->entradas[pos].id != 0) {
+        if (strcmp(indice->entradas[pos].clave, clave) == 0) {
+            indice->entradas[pos].id = id;
+            return;
+        }
+        pos = (pos + 1) & mascara;
     }
-    return -1;
-}
 
-int buscarClientePorCedula(Tienda* tienda, const char* cedula) {
-    for (int i = 0; i < tienda->numClientes; i++) {
-        if (strcmp(tienda->clientes[i].cedula, cedula) == 0)
-            return i;
-    }
-    return -1;
+    strncpy(indice->entradas[pos].clave, clave, LARGO_CLAVE - 1);
+    indice->entradas[pos].clave[LARGO_CLAVE - 1] = '\0';
+    indice->entradas[pos].id = id;
+    indice->num++;
 }
 
-int buscarClientePorNombre(Tienda* tienda, const char* nombre) {
-    for (int i = 0; i < tienda->numClientes; i++) {
-        if (strstr(tienda->clientes[i].nombre, nombre) != nullptr)
-            return i;
+void quitarDeIndiceClave(IndiceClave* indice, const char* clave) {
+    int mascara = indice->capacidad - 1;
+    int pos = hashClave(clave) & mascara;
+
+    while (indice->entradas[pos].id != 0 && strcmp(indice->entradas[pos].clave, clave) != 0)
+        pos = (pos + 1) & mascara;
+
+    if (indice->entradas[pos].id == 0)
+        return;
+
+    // Sin marcas de borrado: las entradas siguientes del mismo grupo se
+    // corren hacia el hueco si su posicin ideal lo permite
+    int hueco = pos;
+    int sig = (pos + 1) & mascara;
+    while (indice->entradas[sig].id != 0) {
+        int ideal = hashClave(indice->entradas[sig].clave) & mascara;
+        if (((sig - ideal) & mascara) >= ((sig - hueco) & mascara)) {
+            indice->entradas[hueco] = indice->entradas[sig];
+            hueco = sig;
+        }
+        sig = (sig + 1) & mascara;
     }
-    return -1;
-}
 
-void mostrarCliente(const Cliente& c) {
-    cout << "\n=== CLIENTE ENCONTRADO ===\n";
-    cout << "ID: " << c.id << endl;
-    cout << "Cdula/RIF: " << c.cedula << endl;
-    cout << "Nombre: " << c.nombre << endl;
-    cout << "Email: " << c.email << endl;
-    cout << "Telfono: " << c.telefono << endl;
-    cout << "Direccin: " << c.direccion << endl;
+    indice->entradas[hueco].id = 0;
+    indice->entradas[hueco].clave[0] = '\0';
+    indice->num--;
 }
 
-//==============
-//tabla clientes
-//==============
-
-void lineaClientes(const char* tipo) {
-    if (strcmp(tipo, "top") == 0)
-        cout << "+-------------------------------------------------------------------------------------------+\n";
-    else if (strcmp(tipo, "mid") == 0)
-        cout << "-------------------------------------------------------------------------------------------\n";
-    else if (strcmp(tipo, "sep") == 0)
-        cout << "----+----------------------+------------------+----------------------+----------------------\n";
-    else if (strcmp(tipo, "bot") == 0)
-        cout << "+-------------------------------------------------------------------------------------------+\n";
+// Igual que los ndices por id, se arman con la primera consulta
+void construirIndiceCodigos(Tienda* tienda) {
+    liberarIndiceClave(&tienda->indiceCodigos);
+    reservarIndiceClave(&tienda->indiceCodigos, tienda->productos.num);
+    for (int i = 0; i < tienda->productos.num; i++)
+        if (activo(tienda->productos[i]))
+            insertarEnIndiceClave(&tienda->indiceCodigos, tienda->productos[i].codigo, tienda->productos[i].id);
+    tienda->indiceCodigos.construido = true;
 }
 
-void encabezadoClientes() {
-    lineaClientes("top");
-    cout << "                                 LISTADO DE CLIENTES                                       \n";
-    lineaClientes("mid");
-    cout << " ID        Nombre            Cdula/RIF           Telfono               Email         \n";
-    lineaClientes("sep");
+void construirIndiceRifs(Tienda* tienda) {
+    liberarIndiceClave(&tienda->indiceRifs);
+    reservarIndiceClave(&tienda->indiceRifs, tienda->proveedores.num);
+    for (int i = 0; i < tienda->proveedores.num; i++)
+        if (activo(tienda->proveedores[i]))
+            insertarEnIndiceClave(&tienda->indiceRifs, tienda->proveedores[i].rif, tienda->proveedores[i].id);
+    tienda->indiceRifs.construido = true;
 }
 
-void filaCliente(const Cliente& c) {
-    cout << " "
-         << setw(2)  << left << c.id << "  "
-         << setw(20) << left << c.nombre << "  "
-         << setw(16) << left << c.cedula << "  "
-         << setw(20) << left << c.telefono << "  "
-         << setw(20) << left << c.email << " \n";
+void construirIndiceCedulas(Tienda* tienda) {
+    liberarIndiceClave(&tienda->indiceCedulas);
+    reservarIndiceClave(&tienda->indiceCedulas, tienda->clientes.num);
+    for (int i = 0; i < tienda->clientes.num; i++)
+        if (activo(tienda->clientes[i]))
+            insertarEnIndiceClave(&tienda->indiceCedulas, tienda->clientes[i].cedula, tienda->clientes[i].id);
+    tienda->indiceCedulas.construido = true;
 }
 
-void pieClientes() {
-    lineaClientes("bot");
+// id del producto con ese cdigo, o -1
+int idPorCodigo(Tienda* tienda, const char* codigo) {
+    if (!tienda->indiceCodigos.construido)
+        construirIndiceCodigos(tienda);
+    return buscarEnIndiceClave(&tienda->indiceCodigos, codigo);
 }
 
-//===============
-//2.1 inicializar
-//===============
+int idPorRif(Tienda* tienda, const char* rif) {
+    if (!tienda->indiceRifs.construido)
+        construirIndiceRifs(tienda);
+    return buscarEnIndiceClave(&tienda->indiceRifs, rif);
+}
 
-void inicializarTienda(Tienda* tienda, const char* nombre, const char* rif){
+int idPorCedula(Tienda* tienda, const char* cedula) {
+    if (!tienda->indiceCedulas.construido)
+        construirIndiceCedulas(tienda);
+    return buscarEnIndiceClave(&tienda->indiceCedulas, cedula);
+}
 
-    strcpy(tienda->nombre, nombre);
-    strcpy(tienda->rif, rif);
-    
-    tienda->capacidadProductos = 5;
-    tienda->capacidadProveedores = 5;
-    tienda->capacidadClientes = 5;
-    tienda->capacidadTransacciones = 5;
+//==============
+//ndices de trigramas
+//==============
 
-    // Contadores
-    tienda->numProductos = 0;
-    tienda->numProveedores = 0;
-    tienda->numClientes = 0;
-    tienda->numTransacciones = 0;
+// ndice invertido trigrama -> ids que lo contienen, para bsquedas por
+// coincidencia parcial. Todo se indexa en minsculas, as que da un
+// superconjunto de candidatos que la bsqueda confirma contra el registro.
+// Al modificar o borrar no se limpian las listas: los ids que sobran se
+// descartan al confirmar y el ndice se rearma si se acumulan demasiados.
+
+void iniciarIndiceTrigramas(IndiceTrigramas* indice) {
+    indice->entradas = nullptr;
+    indice->capacidad = 0;
+    indice->num = 0;
+    indice->obsoletos = 0;
+    indice->construido = false;
+}
 
-    // IDs 
-    tienda->siguienteIdProducto = 1;
-    tienda->siguienteIdProveedor = 1;
-    tienda->siguienteIdCliente = 1;
-    tienda->siguienteIdTransaccion = 1;
+void liberarIndiceTrigramas(IndiceTrigramas* indice) {
+    for (int i = 0; i < indice->capacidad; i++)
+        delete[] indice->entradas[i].lista.ids;
+    delete[] indice->entradas;
+    iniciarIndiceTrigramas(indice);
+}
 
-    // Reservar memoria dinmica
-    tienda->productos = new Producto[tienda->capacidadProductos];
-    tienda->proveedores = new Proveedor[tienda->capacidadProveedores];
-    tienda->clientes = new Cliente[tienda->capacidadClientes];
-    tienda->transacciones = new Transaccion[tienda->capacidadTransacciones];
+// Plegado igual que contieneTexto, para que los candidatos sean un superconjunto
+unsigned int claveTrigrama(const char* t) {
+    return ((unsigned int)plegarCaracter((unsigned char)t[0]) << 16) |
+           ((unsigned int)plegarCaracter((unsigned char)t[1]) << 8) |
+            (unsigned int)plegarCaracter((unsigned char)t[2]);
+}
 
+int posicionTrigrama(const IndiceTrigramas* indice, unsigned int clave) {
+    int mascara = indice->capacidad - 1;
+    int pos = (clave * 2654435761u) & mascara;
+    while (indice->entradas[pos].clave != 0 && indice->entradas[pos].clave != clave)
+        pos = (pos + 1) & mascara;
+    return pos;
 }
 
-//delete
-void liberarTienda(Tienda* tienda) {
-    // Liberar memoria dinmica
-    delete[] tienda->productos;
-    delete[] tienda->proveedores;
-    delete[] tienda->clientes;
-    delete[] tienda->transacciones;
+void redimensionarIndiceTrigramas(IndiceTrigramas* indice) {
+    EntradaTrigrama* viejas = indice->entradas;
+    int capVieja = indice->capacidad;
 
-    // Dejar punteros en nullptr por seguridad
-    tienda->productos = nullptr;
-    tienda->proveedores = nullptr;
-    tienda->clientes = nullptr;
-    tienda->transacciones = nullptr;
+    indice->capacidad = max(capVieja * 2, 1024);
+    indice->entradas = new EntradaTrigrama[indice->capacidad];
+    memset(indice->entradas, 0, indice->capacidad * sizeof(EntradaTrigrama));
 
-    // Reiniciar contadores
-    tienda->numProductos = 0;
-    tienda->numProveedores = 0;
-    tienda->numClientes = 0;
-    tienda->numTransacciones = 0;
+    for (int i = 0; i < capVieja; i++) {
+        if (viejas[i].clave != 0)
+            indice->entradas[posicionTrigrama(indice, viejas[i].clave)] = viejas[i];
+    }
+    delete[] viejas;
 }
 
-//======================
-//2.2.1
-//======================
-
-void crearProducto(Tienda* tienda) {
-    if (!confirmar("Desea registrar un nuevo producto? (S/N): "))
+// Inserta el id manteniendo la lista ordenada y sin repetidos
+void agregarIdALista(ListaIds* lista, int id) {
+    if (lista->num > 0 && lista->ids[lista->num - 1] == id)
         return;
 
-    Producto nuevo;
-
-    // --- Cdigo ---
-   solicitarString(
-    "Ingrese cdigo del producto (o CANCELAR): ",
-    nuevo.codigo,
-    20,
-    sinEspacios,
-    "ERROR: El cdigo no puede contener espacios.\n"
-);
+    if (lista->num >= lista->capacidad) {
+        int nuevaCap = max(lista->capacidad * 2, 4);
+        int* nuevo = new int[nuevaCap];
+        for (int i = 0; i < lista->num; i++)
+            nuevo[i] = lista->ids[i];
+        delete[] lista->ids;
+        lista->ids = nuevo;
+        lista->capacidad = nuevaCap;
+    }
 
-if (strcmp(nuevo.codigo, "CANCELAR") == 0 || strcmp(nuevo.codigo, "0") == 0)
-    return;
+    // Lo normal es que el id sea el mayor (altas); al modificar puede no serlo
+    int pos = lista->num;
+    while (pos > 0 && lista->ids[pos - 1] > id) pos--;
+    if (pos > 0 && lista->ids[pos - 1] == id)
+        return;
 
-if (codigoProductoDuplicado(tienda, nuevo.codigo)) {
-    cout << "ERROR: El cdigo '" << nuevo.codigo << "' ya est registrado.\n";
-    return;
+    for (int i = lista->num; i > pos; i--)
+        lista->ids[i] = lista->ids[i - 1];
+    lista->ids[pos] = id;
+    lista->num++;
 }
 
-    // --- Nombre ---
-    solicitarString("Ingrese nombre del producto (o CANCELAR): ", nuevo.nombre, 100);
-    if (strcmp(nuevo.nombre, "CANCELAR") == 0 || strcmp(nuevo.nombre, "0") == 0)
-        return;
-
-    // --- Descripcin ---
-    solicitarString("Ingrese descripcin (o CANCELAR): ", nuevo.descripcion, 200);
-    if (strcmp(nuevo.descripcion, "CANCELAR") == 0 || strcmp(nuevo.descripcion, "0") == 0)
-        return;
+void indexarTrigramas(IndiceTrigramas* indice, const char* texto, int id) {
+    int len = strlen(texto);
+    for (int i = 0; i + 3 <= len; i++) {
+        if ((indice->num + 1) * 2 > indice->capacidad)
+            redimensionarIndiceTrigramas(indice);
+
+        unsigned int clave = claveTrigrama(texto + i);
+        int pos = posicionTrigrama(indice, clave);
+        if (indice->entradas[pos].clave == 0) {
+            indice->entradas[pos].clave = clave;
+            indice->num++;
+        }
+        agregarIdALista(&indice->entradas[pos].lista, id);
+    }
+}
 
-    // --- ID Proveedor ---
-    cout << "Ingrese ID del proveedor (o 0 para cancelar): ";
-    cin >> nuevo.idProveedor;
+// Interseccin en el sitio de dos listas ordenadas: deja en 'a' lo comn
+int intersectarIds(int* a, int numA, const int* b, int numB) {
+    int i = 0, j = 0, n = 0;
+    while (i < numA && j < numB) {
+        if (a[i] < b[j]) i++;
+        else if (a[i] > b[j]) j++;
+        else {
+            a[n++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    return n;
+}
 
-    if (nuevo.idProveedor == 0)
-        return;
+// Ids (ordenados) que contienen todos los trigramas de 'patron'. Devuelve
+// nullptr con *num = -1 si el patrn es muy corto para usar el ndice.
+int* candidatosTrigramas(const IndiceTrigramas* indice, const char* patron, int* num) {
+    int len = strlen(patron);
+    if (len < 3) {
+        *num = -1;
+        return nullptr;
+    }
+    if (indice->capacidad == 0) {
+        // Se arm sobre una tabla vaca
+        *num = 0;
+        return nullptr;
+    }
 
-    if (!existeProveedor(tienda, nuevo.idProveedor)) {
-        cout << "ERROR: El proveedor con ID " << nuevo.idProveedor << " no existe.\n";
-        return;
+    // Empezar por la lista ms corta y recortar con las dems
+    const ListaIds* menor = nullptr;
+    for (int i = 0; i + 3 <= len; i++) {
+        int pos = posicionTrigrama(indice, claveTrigrama(patron + i));
+        if (indice->entradas[pos].clave == 0) {
+            *num = 0;
+            return nullptr;
+        }
+        const ListaIds* lista = &indice->entradas[pos].lista;
+        if (menor == nullptr || lista->num < menor->num)
+            menor = lista;
     }
 
-    // --- Precio ---
-    nuevo.precio = solicitarEnteroPositivo("Ingrese precio (>0): ");
+    int* ids = new int[menor->num > 0 ? menor->num : 1];
+    int n = menor->num;
+    for (int i = 0; i < n; i++)
+        ids[i] = menor->ids[i];
 
-    // --- Stock ---
-    nuevo.stock = solicitarEnteroNoNegativo("Ingrese stock (>=0): ");
+    for (int i = 0; i + 3 <= len && n > 0; i++) {
+        const ListaIds* lista = &indice->entradas[posicionTrigrama(indice, claveTrigrama(patron + i))].lista;
+        if (lista != menor)
+            n = intersectarIds(ids, n, lista->ids, lista->num);
+    }
 
-    // Fecha automtica
-    obtenerFechaActual(nuevo.fechaRegistro);
+    *num = n;
+    return ids;
+}
 
-    // --- Resumen ---
-    cout << "\n=== RESUMEN DEL PRODUCTO ===\n";
-    mostrarProducto(nuevo);
+void construirTrigramasNombreProducto(Tienda* tienda) {
+    liberarIndiceTrigramas(&tienda->trigramasNombreProducto);
+    for (int i = 0; i < tienda->productos.num; i++)
+        if (activo(tienda->productos[i]))
+            indexarTrigramas(&tienda->trigramasNombreProducto, tienda->productos[i].nombre, tienda->productos[i].id);
+    tienda->trigramasNombreProducto.construido = true;
+}
 
-    if (!confirmar("Guardar producto? (S/N): "))
-        return;
+void construirTrigramasCodigoProducto(Tienda* tienda) {
+    liberarIndiceTrigramas(&tienda->trigramasCodigoProducto);
+    for (int i = 0; i < tienda->productos.num; i++)
+        if (activo(tienda->productos[i]))
+            indexarTrigramas(&tienda->trigramasCodigoProducto, tienda->productos[i].codigo, tienda->productos[i].id);
+    tienda->trigramasCodigoProducto.construido = true;
+}
 
-    // --- Redimensionar si es necesario ---
-    if (tienda->numProductos >= tienda->capacidadProductos) {
-    redimensionarProductos(tienda);
+void construirTrigramasNombreProveedor(Tienda* tienda) {
+    liberarIndiceTrigramas(&tienda->trigramasNombreProveedor);
+    for (int i = 0; i < tienda->proveedores.num; i++)
+        if (activo(tienda->proveedores[i]))
+            indexarTrigramas(&tienda->trigramasNombreProveedor, tienda->proveedores[i].nombre, tienda->proveedores[i].id);
+    tienda->trigramasNombreProveedor.construido = true;
 }
 
+void construirTrigramasNombreCliente(Tienda* tienda) {
+    liberarIndiceTrigramas(&tienda->trigramasNombreCliente);
+    for (int i = 0; i < tienda->clientes.num; i++)
+        if (activo(tienda->clientes[i]))
+            indexarTrigramas(&tienda->trigramasNombreCliente, tienda->clientes[i].nombre, tienda->clientes[i].id);
+    tienda->trigramasNombreCliente.construido = true;
+}
 
-    // Guardado final
-    nuevo.id = tienda->siguienteIdProducto++;
-    tienda->productos[tienda->numProductos++] = nuevo;
+// Arma el ndice si falta, o lo rearma si ya tiene ms ids obsoletos que
+// registros vivos
+void refrescarTrigramas(Tienda* tienda, IndiceTrigramas* indice, void (*construir)(Tienda*),
+                        int vivos) {
+    if (!indice->construido || indice->obsoletos > vivos)
+        construir(tienda);
+}
 
-    cout << "\nProducto registrado exitosamente.\n";
+// Candidatos de un ndice de la tienda, al da antes de consultarlo
+int* candidatosEnTienda(Tienda* tienda, IndiceTrigramas* indice, void (*construir)(Tienda*),
+                        int vivos, const char* patron, int* num) {
+    if (strlen(patron) < 3) {
+        *num = -1;
+        return nullptr;
+    }
+    refrescarTrigramas(tienda, indice, construir, vivos);
+    return candidatosTrigramas(indice, patron, num);
 }
 
-//========================
-//2.2.2
-//========================
+// Mantenimiento desde agregar*/reemplazar*/quitar*
+void trigramasAlta(IndiceTrigramas* indice, const char* texto, int id) {
+    if (indice->construido)
+        indexarTrigramas(indice, texto, id);
+}
 
-void buscarProducto(Tienda* tienda) {
-    int opcion;
-    cout << "\n=== BUSCAR PRODUCTO ===\n";
-    cout << "1. Buscar por ID\n";
-    cout << "2. Buscar por nombre (parcial)\n";
-    cout << "3. Buscar por cdigo (parcial)\n";
-    cout << "4. Listar por proveedor\n";
-    cout << "0. Cancelar\n";
-    cout << "Seleccione una opcin: ";
-    cin >> opcion;
+void trigramasCambio(IndiceTrigramas* indice, const char* anterior, const char* nuevo, int id) {
+    if (!indice->construido || strcmp(anterior, nuevo) == 0) return;
+    indexarTrigramas(indice, nuevo, id);
+    indice->obsoletos++;
+}
 
-    if (opcion == 0) return;
+void trigramasBaja(IndiceTrigramas* indice) {
+    if (indice->construido)
+        indice->obsoletos++;
+}
 
-    char buffer[200];
-    string filtro;
+//==============
+//ndice proveedor -> productos
+//==============
 
-    switch (opcion) {
+void iniciarIndiceProveedorProductos(IndiceProveedorProductos* indice) {
+    indice->listas = nullptr;
+    indice->capacidad = 0;
+    indice->construido = false;
+}
 
-    // 1. Buscar por ID
-    case 1: {
-        int id;
-        cout << "Ingrese ID del producto: ";
-        cin >> id;
+void liberarIndiceProveedorProductos(IndiceProveedorProductos* indice) {
+    for (int i = 0; i < indice->capacidad; i++)
+        delete[] indice->listas[i].ids;
+    delete[] indice->listas;
+    iniciarIndiceProveedorProductos(indice);
+}
 
-        int index = buscarProductoPorID(tienda, id);
-        if (index == -1) {
-            cout << "ERROR: No se encontr un producto con ID " << id << ".\n";
-            return;
+// Lista del proveedor; crece el ndice si el id an no tiene lugar
+ListaIds* listaDeProveedor(IndiceProveedorProductos* indice, int idProveedor) {
+    if (idProveedor >= indice->capacidad) {
+        int nuevaCap = max(indice->capacidad * 2, 16);
+        while (nuevaCap <= idProveedor) nuevaCap *= 2;
+
+        ListaIds* nuevo = new ListaIds[nuevaCap];
+        for (int i = 0; i < indice->capacidad; i++)
+            nuevo[i] = indice->listas[i];
+        for (int i = indice->capacidad; i < nuevaCap; i++) {
+            nuevo[i].ids = nullptr;
+            nuevo[i].num = 0;
+            nuevo[i].capacidad = 0;
         }
 
-        cout << "\n=== PRODUCTO ENCONTRADO ===\n";
-        mostrarProducto(tienda->productos[index]);
-        return;
+        delete[] indice->listas;
+        indice->listas = nuevo;
+        indice->capacidad = nuevaCap;
     }
+    return &indice->listas[idProveedor];
+}
 
-    // 2. Buscar por nombre (parcial)
-    case 2: {
-    solicitarString("Ingrese parte del nombre: ", buffer, 200);
+void quitarIdDeLista(ListaIds* lista, int id) {
+    int ini = 0, fin = lista->num;
+    while (ini < fin) {
+        int medio = (ini + fin) / 2;
+        if (lista->ids[medio] < id) ini = medio + 1;
+        else fin = medio;
+    }
+    if (ini == lista->num || lista->ids[ini] != id)
+        return;
 
-    int numResultados = 0;
-    int* indices = buscarProductosPorNombre(tienda, buffer, &numResultados);
+    for (int i = ini; i < lista->num - 1; i++)
+        lista->ids[i] = lista->ids[i + 1];
+    lista->num--;
+}
 
-    if (numResultados == 0) {
-        cout << "No se encontraron coincidencias.\n";
-        return;
+void construirIndiceProveedorProductos(Tienda* tienda) {
+    IndiceProveedorProductos* indice = &tienda->productosPorProveedor;
+    liberarIndiceProveedorProductos(indice);
+    for (int i = 0; i < tienda->productos.num; i++) {
+        const Producto& p = tienda->productos[i];
+        if (activo(p) && p.idProveedor > 0)
+            agregarIdALista(listaDeProveedor(indice, p.idProveedor), p.id);
     }
+    indice->construido = true;
+}
 
-    cout << "\n=== RESULTADOS ===\n";
-    for (int i = 0; i < numResultados; i++) {
-        int idx = indices[i];
-        mostrarProducto(tienda->productos[idx]);
-        cout << "-----------------------------\n";
-    }
+// Ids (ordenados) de los productos del proveedor; nullptr si no tiene
+const ListaIds* productosDeProveedor(Tienda* tienda, int idProveedor) {
+    IndiceProveedorProductos* indice = &tienda->productosPorProveedor;
+    if (!indice->construido)
+        construirIndiceProveedorProductos(tienda);
+    if (idProveedor <= 0 || idProveedor >= indice->capacidad || indice->listas[idProveedor].num == 0)
+        return nullptr;
+    return &indice->listas[idProveedor];
+}
 
-    delete[] indices; // obligatorio
-    return;
-	}
+//==============
+//ndices por fecha
+//==============
 
+// Una lista de ids ordenada por da, as que alta y baja solo tocan la lista
+// de su fecha y un rango se copia da por da. El arreglo de das crece hacia
+// el lado de la fecha que no entra.
 
-    // 3. Buscar por cdigo (parcial)
-    case 3: {
-        solicitarString("Ingrese parte del cdigo: ", buffer, 200);
-        filtro = toLower(buffer);
+void iniciarIndiceFechas(IndiceFechas* indice) {
+    indice->dias = nullptr;
+    indice->primerDia = 0;
+    indice->numDias = 0;
+    indice->construido = false;
+}
 
-        bool encontrado = false;
-        cout << "\n=== RESULTADOS ===\n";
+void liberarIndiceFechas(IndiceFechas* indice) {
+    for (int i = 0; i < indice->numDias; i++)
+        delete[] indice->dias[i].ids;
+    delete[] indice->dias;
+    iniciarIndiceFechas(indice);
+}
 
-        for (int i = 0; i < tienda->numProductos; i++) {
-            if (contiene(tienda->productos[i].codigo, filtro)) {
-                mostrarProducto(tienda->productos[i]);
-                cout << "-----------------------------\n";
-                encontrado = true;
-            }
+// Lista del da; crece el arreglo si la fecha an no tiene lugar
+ListaIds* listaDeDia(IndiceFechas* indice, int fecha) {
+    int primero = indice->primerDia;
+    int fin = indice->primerDia + indice->numDias;
+    if (indice->numDias == 0 || fecha < primero || fecha >= fin) {
+        int holgura = max(indice->numDias / 2, 64);
+        if (indice->numDias == 0) {
+            primero = fecha - holgura;
+            fin = fecha + holgura;
+        } else if (fecha < primero) {
+            primero = fecha - holgura;
+        } else {
+            fin = fecha + holgura;
         }
 
-        if (!encontrado)
-            cout << "No se encontraron coincidencias.\n";
+        ListaIds* nuevos = new ListaIds[fin - primero];
+        for (int i = 0; i < fin - primero; i++) {
+            nuevos[i].ids = nullptr;
+            nuevos[i].num = 0;
+            nuevos[i].capacidad = 0;
+        }
+        for (int i = 0; i < indice->numDias; i++)
+            nuevos[indice->primerDia - primero + i] = indice->dias[i];
 
-        return;
+        delete[] indice->dias;
+        indice->dias = nuevos;
+        indice->primerDia = primero;
+        indice->numDias = fin - primero;
     }
+    return &indice->dias[fecha - indice->primerDia];
+}
 
-    // 4. Listar por proveedor
-    case 4: {
-        int idProv;
-        cout << "Ingrese ID del proveedor: ";
-        cin >> idProv;
+void insertarEnIndiceFechas(IndiceFechas* indice, int fecha, int id) {
+    agregarIdALista(listaDeDia(indice, fecha), id);
+}
 
-        if (!existeProveedor(tienda, idProv)) {
-            cout << "ERROR: El proveedor con ID " << idProv << " no existe.\n";
-            return;
-        }
+void quitarDeIndiceFechas(IndiceFechas* indice, int fecha, int id) {
+    int dia = fecha - indice->primerDia;
+    if (dia >= 0 && dia < indice->numDias)
+        quitarIdDeLista(&indice->dias[dia], id);
+}
 
-        bool encontrado = false;
-        cout << "\n=== PRODUCTOS DEL PROVEEDOR " 
-             << obtenerNombreProveedor(tienda, idProv) << " ===\n";
+template <typename T>
+void construirIndiceFechas(IndiceFechas* indice, Tabla<T>& t, int T::*fecha) {
+    liberarIndiceFechas(indice);
+    paraCadaActivo(t, [&](T& r, int) { insertarEnIndiceFechas(indice, r.*fecha, r.id); });
+    indice->construido = true;
+}
 
-        for (int i = 0; i < tienda->numProductos; i++) {
-            if (tienda->productos[i].idProveedor == idProv) {
-                mostrarProducto(tienda->productos[i]);
-                cout << "-----------------------------\n";
-                encontrado = true;
-            }
-        }
+IndiceFechas* fechasDeProductos(Tienda* tienda) {
+    if (!tienda->fechasProductos.construido)
+        construirIndiceFechas(&tienda->fechasProductos, tienda->productos, &Producto::fechaRegistro);
+    return &tienda->fechasProductos;
+}
 
-        if (!encontrado)
-            cout << "No hay productos asociados a ese proveedor.\n";
+IndiceFechas* fechasDeTransacciones(Tienda* tienda) {
+    if (!tienda->fechasTransacciones.construido)
+        construirIndiceFechas(&tienda->fechasTransacciones, tienda->transacciones, &Transaccion::fecha);
+    return &tienda->fechasTransacciones;
+}
 
-        return;
-    }
+// Posiciones (ordenadas por fecha) de los registros con fecha en [desde, hasta]
+template <typename T>
+int* posicionesEnRango(const IndiceFechas* indice, Tabla<T>* t, int desde, int hasta, int* numResultados) {
+    long long primero = max((long long)desde - indice->primerDia, 0LL);
+    long long ultimo = min((long long)hasta - indice->primerDia, (long long)indice->numDias - 1);
+    *numResultados = 0;
+    for (long long dia = primero; dia <= ultimo; dia++)
+        *numResultados += indice->dias[dia].num;
+    if (*numResultados == 0)
+        return nullptr;
 
-    default:
-        cout << "Opcin invlida.\n";
-        return;
+    int* resultados = new int[*numResultados];
+    int n = 0;
+    for (long long dia = primero; dia <= ultimo; dia++) {
+        const ListaIds* lista = &indice->dias[dia];
+        for (int i = 0; i < lista->num; i++)
+            resultados[n++] = posicionEnTabla(t, lista->ids[i]);
     }
+    return resultados;
 }
 
-//========================
-//2.2.3
-//========================
+int* productosRegistradosEntre(Tienda* tienda, int desde, int hasta, int* numResultados) {
+    return posicionesEnRango(fechasDeProductos(tienda), &tienda->productos, desde, hasta, numResultados);
+}
 
-void actualizarProducto(Tienda* tienda) {
-    int id;
-    cout << "Ingrese el ID del producto a actualizar: ";
-    cin >> id;
+int* transaccionesEntre(Tienda* tienda, int desde, int hasta, int* numResultados) {
+    return posicionesEnRango(fechasDeTransacciones(tienda), &tienda->transacciones, desde, hasta, numResultados);
+}
 
-    int index = buscarProductoPorID(tienda, id);
-    if (index == -1) {
-        cout << "ERROR: No existe un producto con ese ID.\n";
-        return;
+//==============
+//totales de inventario
+//==============
+
+// Se arman con una pasada la primera vez que se piden; despus cada
+// primitiva de productos resta el registro viejo y suma el nuevo.
+
+void iniciarAgregados(AgregadosInventario* ag) {
+    memset(&ag->global, 0, sizeof(ag->global));
+    ag->porProveedor = nullptr;
+    ag->capacidad = 0;
+    ag->construido = false;
+}
+
+void liberarAgregados(AgregadosInventario* ag) {
+    delete[] ag->porProveedor;
+    iniciarAgregados(ag);
+}
+
+TotalesInventario* totalesDeProveedor(AgregadosInventario* ag, int idProveedor) {
+    if (idProveedor >= ag->capacidad) {
+        int nuevaCap = max(ag->capacidad * 2, 16);
+        while (nuevaCap <= idProveedor) nuevaCap *= 2;
+
+        TotalesInventario* nuevo = new TotalesInventario[nuevaCap];
+        for (int i = 0; i < ag->capacidad; i++)
+            nuevo[i] = ag->porProveedor[i];
+        memset(nuevo + ag->capacidad, 0, (nuevaCap - ag->capacidad) * sizeof(TotalesInventario));
+
+        delete[] ag->porProveedor;
+        ag->porProveedor = nuevo;
+        ag->capacidad = nuevaCap;
     }
+    return &ag->porProveedor[idProveedor];
+}
 
-    Producto* original = &tienda->productos[index];
-    Producto temp = *original; // copia temporal
+long long centavosDe(float precio) {
+    double c = (double)precio * 100.0;
+    return (long long)(c < 0 ? c - 0.5 : c + 0.5);
+}
 
-    int opcion;
+// Suma (signo = 1) o resta (signo = -1) un producto de los totales
+void acumularProducto(AgregadosInventario* ag, const Producto& p, int signo) {
+    long long valor = centavosDe(p.precio) * p.stock;
+    ag->global.productos += signo;
+    ag->global.unidades += signo * (long long)p.stock;
+    ag->global.valorCentavos += signo * valor;
+
+    if (p.idProveedor > 0) {
+        TotalesInventario* t = totalesDeProveedor(ag, p.idProveedor);
+        t->productos += signo;
+        t->unidades += signo * (long long)p.stock;
+        t->valorCentavos += signo * valor;
+    }
+}
 
-    do {
-        cout << "\n=== EDITAR PRODUCTO ===\n";
-        cout << "1. Cdigo: " << temp.codigo << endl;
-        cout << "2. Nombre: " << temp.nombre << endl;
-        cout << "3. Descripcin: " << temp.descripcion << endl;
-        cout << "4. Proveedor ID: " << temp.idProveedor << endl;
-        cout << "5. Precio: " << temp.precio << endl;
-        cout << "6. Stock: " << temp.stock << endl;
-        cout << "7. Guardar cambios\n";
-        cout << "0. Cancelar sin guardar\n";
-        cout << "Opcin: ";
-        cin >> opcion;
+void construirAgregados(Tienda* tienda) {
+    AgregadosInventario* ag = &tienda->agregados;
+    liberarAgregados(ag);
+    paraCadaActivo(tienda->productos, [&](Producto& p, int) { acumularProducto(ag, p, 1); });
+    ag->construido = true;
+}
 
-        cin.ignore(); // limpiar buffer
+AgregadosInventario* agregadosDeInventario(Tienda* tienda) {
+    if (!tienda->agregados.construido)
+        construirAgregados(tienda);
+    return &tienda->agregados;
+}
 
-        switch (opcion) {
+// Totales de un proveedor (todo en cero si no tiene productos)
+TotalesInventario totalesProveedor(Tienda* tienda, int idProveedor) {
+    AgregadosInventario* ag = agregadosDeInventario(tienda);
+    TotalesInventario vacio = { 0, 0, 0 };
+    if (idProveedor <= 0 || idProveedor >= ag->capacidad)
+        return vacio;
+    return ag->porProveedor[idProveedor];
+}
 
-        case 1: { // Cdigo
-            char nuevoCodigo[20];
-            solicitarString("Nuevo cdigo: ", nuevoCodigo, 20);
+//==============
+//ndice de reposicin
+//==============
 
-            if (codigoProductoDuplicado(tienda, nuevoCodigo, temp.id)) {
-                cout << "ERROR: El cdigo '" << nuevoCodigo << "' ya est registrado.\n";
-            } else {
-                strcpy(temp.codigo, nuevoCodigo);
-            }
-            break;
-        }
+// Montculos de mnimos con los productos que tienen stock mnimo, ordenados
+// por holgura (stock - stockMinimo) y despus por id: en la raz est el ms
+// urgente. Hay uno con todos y uno por proveedor, para que pedir los de un
+// proveedor no recorra los de los dems. Con la posicin de cada id en los
+// dos, un cambio de stock, un alta o una baja mueve solo ese producto, en
+// O(log n).
+
+void iniciarIndiceReposicion(IndiceReposicion* r) {
+    memset(&r->todos, 0, sizeof(r->todos));
+    r->porProveedor = nullptr;
+    r->capacidadProveedores = 0;
+    r->posiciones = nullptr;
+    r->posicionesProveedor = nullptr;
+    r->capacidadPosiciones = 0;
+    r->construido = false;
+}
 
-        case 2: // Nombre
-            solicitarString("Nuevo nombre: ", temp.nombre, 100);
-            break;
+void liberarIndiceReposicion(IndiceReposicion* r) {
+    delete[] r->todos.entradas;
+    for (int i = 0; i < r->capacidadProveedores; i++)
+        delete[] r->porProveedor[i].entradas;
+    delete[] r->porProveedor;
+    delete[] r->posiciones;
+    delete[] r->posicionesProveedor;
+    iniciarIndiceReposicion(r);
+}
 
-        case 3: // Descripcin
-            solicitarString("Nueva descripcin: ", temp.descripcion, 200);
-            break;
+bool masUrgente(const EntradaReposicion& a, const EntradaReposicion& b) {
+    return a.holgura < b.holgura || (a.holgura == b.holgura && a.id < b.id);
+}
 
-        case 4: { // Proveedor
-            int nuevoProv;
-            cout << "Nuevo ID de proveedor: ";
-            cin >> nuevoProv;
+void colocarEnMonticulo(MonticuloReposicion* m, int* posiciones, int pos, const EntradaReposicion& e) {
+    m->entradas[pos] = e;
+    posiciones[e.id] = pos;
+}
 
-            if (!existeProveedor(tienda, nuevoProv)) {
-                cout << "ERROR: El proveedor con ID " << nuevoProv << " no existe.\n";
-            } else {
-                temp.idProveedor = nuevoProv;
-            }
+void subirEnMonticulo(MonticuloReposicion* m, int* posiciones, int pos) {
+    EntradaReposicion e = m->entradas[pos];
+    while (pos > 0) {
+        int padre = (pos - 1) / 2;
+        if (!masUrgente(e, m->entradas[padre]))
             break;
-        }
+        colocarEnMonticulo(m, posiciones, pos, m->entradas[padre]);
+        pos = padre;
+    }
+    colocarEnMonticulo(m, posiciones, pos, e);
+}
 
-        case 5: // Precio
-            temp.precio = solicitarEnteroPositivo("Nuevo precio (>0): ");
+void bajarEnMonticulo(MonticuloReposicion* m, int* posiciones, int pos) {
+    EntradaReposicion e = m->entradas[pos];
+    while (true) {
+        int hijo = 2 * pos + 1;
+        if (hijo >= m->num)
             break;
-
-        case 6: // Stock
-            temp.stock = solicitarEnteroNoNegativo("Nuevo stock (>=0): ");
+        if (hijo + 1 < m->num && masUrgente(m->entradas[hijo + 1], m->entradas[hijo]))
+            hijo++;
+        if (!masUrgente(m->entradas[hijo], e))
             break;
+        colocarEnMonticulo(m, posiciones, pos, m->entradas[hijo]);
+        pos = hijo;
+    }
+    colocarEnMonticulo(m, posiciones, pos, e);
+}
 
-        case 7: // Guardar cambios
-            cout << "\n=== RESUMEN FINAL ===\n";
-            mostrarProducto(temp);
+// Deja en 'pos' la entrada e y la lleva a su lugar
+void reubicarEnMonticulo(MonticuloReposicion* m, int* posiciones, int pos, const EntradaReposicion& e) {
+    colocarEnMonticulo(m, posiciones, pos, e);
+    if (pos > 0 && masUrgente(e, m->entradas[(pos - 1) / 2]))
+        subirEnMonticulo(m, posiciones, pos);
+    else
+        bajarEnMonticulo(m, posiciones, pos);
+}
 
-            if (confirmar("Confirmar cambios? (S/N): ")) {
-                *original = temp;
-                cout << "Cambios guardados exitosamente.\n";
-            } else {
-                cout << "Cambios descartados.\n";
-            }
-            return;
+// Agrega e o la actualiza si su id ya estaba
+void ponerEnMonticulo(MonticuloReposicion* m, int* posiciones, const EntradaReposicion& e) {
+    int pos = posiciones[e.id];
+    if (pos == -1) {
+        if (m->num >= m->capacidad) {
+            int nuevaCap = max(m->capacidad * 2, 16);
+            EntradaReposicion* nuevas = new EntradaReposicion[nuevaCap];
+            for (int i = 0; i < m->num; i++)
+                nuevas[i] = m->entradas[i];
+            delete[] m->entradas;
+            m->entradas = nuevas;
+            m->capacidad = nuevaCap;
+        }
+        pos = m->num++;
+    }
+    reubicarEnMonticulo(m, posiciones, pos, e);
+}
 
-        case 0:
-            cout << "Cancelado. No se guardaron cambios.\n";
-            return;
+void sacarDeMonticulo(MonticuloReposicion* m, int* posiciones, int id) {
+    int pos = posiciones[id];
+    posiciones[id] = -1;
+    m->num--;
+    if (pos < m->num)
+        reubicarEnMonticulo(m, posiciones, pos, m->entradas[m->num]);
+}
 
-        default:
-            cout << "Opcin invlida.\n";
-        }
+void reservarPosicionesReposicion(IndiceReposicion* r, int id) {
+    if (id < r->capacidadPosiciones)
+        return;
+    int nuevaCap = max(r->capacidadPosiciones * 2, 256);
+    while (nuevaCap <= id) nuevaCap *= 2;
+
+    int* nuevas = new int[nuevaCap];
+    int* nuevasProveedor = new int[nuevaCap];
+    for (int i = 0; i < nuevaCap; i++) {
+        nuevas[i] = i < r->capacidadPosiciones ? r->posiciones[i] : -1;
+        nuevasProveedor[i] = i < r->capacidadPosiciones ? r->posicionesProveedor[i] : -1;
+    }
+    delete[] r->posiciones;
+    delete[] r->posicionesProveedor;
+    r->posiciones = nuevas;
+    r->posicionesProveedor = nuevasProveedor;
+    r->capacidadPosiciones = nuevaCap;
+}
 
-    } while (true);
+MonticuloReposicion* monticuloDeProveedor(IndiceReposicion* r, int idProveedor) {
+    if (idProveedor >= r->capacidadProveedores) {
+        int nuevaCap = max(r->capacidadProveedores * 2, 16);
+        while (nuevaCap <= idProveedor) nuevaCap *= 2;
+
+        MonticuloReposicion* nuevos = new MonticuloReposicion[nuevaCap];
+        for (int i = 0; i < r->capacidadProveedores; i++)
+            nuevos[i] = r->porProveedor[i];
+        memset(nuevos + r->capacidadProveedores, 0,
+               (nuevaCap - r->capacidadProveedores) * sizeof(MonticuloReposicion));
+        delete[] r->porProveedor;
+        r->porProveedor = nuevos;
+        r->capacidadProveedores = nuevaCap;
+    }
+    return &r->porProveedor[idProveedor];
 }
 
-//========================
-//2.2.4
-//========================
+void quitarDeReposicion(IndiceReposicion* r, int id) {
+    if (id < 0 || id >= r->capacidadPosiciones || r->posiciones[id] == -1)
+        return;
 
-void actualizarStockProducto(Tienda* tienda) {
-    int id;
-    cout << "Ingrese el ID del producto: ";
-    cin >> id;
+    int idProveedor = r->todos.entradas[r->posiciones[id]].idProveedor;
+    sacarDeMonticulo(monticuloDeProveedor(r, idProveedor), r->posicionesProveedor, id);
+    sacarDeMonticulo(&r->todos, r->posiciones, id);
+}
 
-    int index = buscarProductoPorID(tienda, id);
-    if (index == -1) {
-        cout << "ERROR: No existe un producto con ese ID.\n";
+// Deja el producto donde corresponde segn su stock, su stock mnimo y su
+// proveedor actuales
+void reposicionProducto(IndiceReposicion* r, const Producto& p) {
+    if (p.stockMinimo <= 0) {
+        quitarDeReposicion(r, p.id);
         return;
     }
 
-    Producto* p = &tienda->productos[index];
+    reservarPosicionesReposicion(r, p.id);
+    int pos = r->posiciones[p.id];
+    if (pos != -1 && r->todos.entradas[pos].idProveedor != p.idProveedor) {
+        sacarDeMonticulo(monticuloDeProveedor(r, r->todos.entradas[pos].idProveedor),
+                         r->posicionesProveedor, p.id);
+    }
 
-    cout << "\n=== ACTUALIZAR STOCK ===\n";
-    cout << "Producto: " << p->nombre << endl;
-    cout << "Stock actual: " << p->stock << endl;
+    EntradaReposicion e = { p.stock - p.stockMinimo, p.id, p.idProveedor };
+    ponerEnMonticulo(&r->todos, r->posiciones, e);
+    ponerEnMonticulo(monticuloDeProveedor(r, p.idProveedor), r->posicionesProveedor, e);
+}
 
-    int ajuste;
-    cout << "Ingrese ajuste (+ para aumentar, - para disminuir): ";
-    cin >> ajuste;
+void construirIndiceReposicion(Tienda* tienda) {
+    IndiceReposicion* r = &tienda->reposicion;
+    liberarIndiceReposicion(r);
+    reservarPosicionesReposicion(r, tienda->siguienteIdProducto);
+    paraCadaActivo(tienda->productos, [&](Producto& p, int) { reposicionProducto(r, p); });
+    r->construido = true;
+}
 
-    int nuevoStock = p->stock + ajuste;
+IndiceReposicion* reposicionDeProductos(Tienda* tienda) {
+    if (!tienda->reposicion.construido)
+        construirIndiceReposicion(tienda);
+    return &tienda->reposicion;
+}
 
-    if (nuevoStock < 0) {
-        cout << "ERROR: Stock insuficiente. Disponible: " 
-             << p->stock << ", Solicitado: " << (-ajuste) << endl;
-        return;
+// Hasta k productos (0 = todos) con stock por debajo del mnimo, los ms
+// urgentes; con idProveedor > 0 solo los de ese proveedor. Devuelve sus
+// posiciones agrupadas por proveedor y, dentro de cada uno, por urgencia.
+//
+// Recorre el montculo desde la raz con una frontera ordenada, as que solo
+// toca los productos que devuelve y sus hijos.
+int* productosPorReponer(Tienda* tienda, int k, int idProveedor, int* numResultados) {
+    IndiceReposicion* r = reposicionDeProductos(tienda);
+    const MonticuloReposicion* m = &r->todos;
+    if (idProveedor > 0)
+        m = idProveedor < r->capacidadProveedores ? &r->porProveedor[idProveedor] : nullptr;
+
+    *numResultados = 0;
+    if (m == nullptr || m->num == 0 || m->entradas[0].holgura >= 0)
+        return nullptr;
+
+    int capResultados = k > 0 ? min(k, m->num) : 64;
+    EntradaReposicion* elegidos = new EntradaReposicion[capResultados];
+    int numElegidos = 0;
+
+    // Frontera: posiciones del montculo por visitar, la ms urgente primero
+    int capFrontera = 64;
+    int* frontera = new int[capFrontera];
+    int numFrontera = 0;
+    auto menosUrgente = [m](int a, int b) { return masUrgente(m->entradas[b], m->entradas[a]); };
+    auto agregarFrontera = [&](int pos) {
+        if (pos >= m->num || m->entradas[pos].holgura >= 0)
+            return;
+        if (numFrontera == capFrontera) {
+            int* nueva = new int[capFrontera * 2];
+            for (int i = 0; i < numFrontera; i++)
+                nueva[i] = frontera[i];
+            delete[] frontera;
+            frontera = nueva;
+            capFrontera *= 2;
+        }
+        frontera[numFrontera++] = pos;
+        push_heap(frontera, frontera + numFrontera, menosUrgente);
+    };
+
+    agregarFrontera(0);
+    while (numFrontera > 0 && (k <= 0 || numElegidos < k)) {
+        pop_heap(frontera, frontera + numFrontera, menosUrgente);
+        int pos = frontera[--numFrontera];
+
+        if (numElegidos == capResultados) {
+            EntradaReposicion* nuevos = new EntradaReposicion[capResultados * 2];
+            for (int i = 0; i < numElegidos; i++)
+                nuevos[i] = elegidos[i];
+            delete[] elegidos;
+            elegidos = nuevos;
+            capResultados *= 2;
+        }
+        elegidos[numElegidos++] = m->entradas[pos];
+        agregarFrontera(2 * pos + 1);
+        agregarFrontera(2 * pos + 2);
     }
+    delete[] frontera;
+
+    // Ya estn por urgencia: un orden estable por proveedor la conserva
+    stable_sort(elegidos, elegidos + numElegidos,
+                [](const EntradaReposicion& a, const EntradaReposicion& b) {
+                    return a.idProveedor < b.idProveedor;
+                });
+
+    int* resultados = new int[numElegidos];
+    for (int i = 0; i < numElegidos; i++)
+        resultados[i] = posicionEnTabla(&tienda->productos, elegidos[i].id);
+    delete[] elegidos;
+    *numResultados = numElegidos;
+    return resultados;
+}
 
-    cout << "Stock final sera: " << nuevoStock << endl;
+//==============
+//ndices de orden para los listados
+//==============
 
-    if (!confirmar("Confirmar cambio? (S/N): "))
-        return;
+// Cada ndice es un treap (rbol binario de bsqueda con prioridades al
+// azar) que guarda en cada nodo el tamao de su subrbol: insertar, quitar y
+// encontrar el registro nmero k del orden cuestan O(log n), y una pgina se
+// recorre desde ah en orden, as que mostrar la pgina p cuesta
+// O(log n + tamao de pgina) en vez de ordenar la tabla.
+//
+// Los nodos guardan el id y una clave numrica: el valor del campo, o en los
+// de nombre los primeros 8 bytes plegados del texto, que deciden casi todas
+// las comparaciones sin ir al registro. Los empates se desempatan por id.
+
+void iniciarIndiceOrden(IndiceOrden* ix, bool porTexto) {
+    ix->nodos = nullptr;
+    ix->raiz = 0;
+    ix->usados = 1;
+    ix->capacidad = 0;
+    ix->libre = 0;
+    ix->semilla = 0x9E3779B9u;
+    ix->porTexto = porTexto;
+    ix->construido = false;
+}
 
-    p->stock = nuevoStock;
-    cout << "Stock actualizado exitosamente.\n";
+void liberarIndiceOrden(IndiceOrden* ix) {
+    delete[] ix->nodos;
+    iniciarIndiceOrden(ix, ix->porTexto);
 }
 
-//========================
-//2.2.5
-//========================
+// Valor con signo llevado a un orden sin signo equivalente
+unsigned long long claveNumerica(long long valor) {
+    return (unsigned long long)valor ^ (1ULL << 63);
+}
 
-void listarProductos(Tienda* tienda) {
-    if (tienda->numProductos == 0) {
-        cout << "No hay productos registrados.\n";
-        return;
+unsigned long long prefijoPlegado(const char* texto) {
+    unsigned long long prefijo = 0;
+    int i = 0;
+    for (; i < 8 && texto[i] != '\0'; i++)
+        prefijo = (prefijo << 8) | plegarCaracter((unsigned char)texto[i]);
+    for (; i < 8; i++)
+        prefijo <<= 8;
+    return prefijo;
+}
+
+int compararPlegados(const char* a, const char* b) {
+    const unsigned char* x = (const unsigned char*)a;
+    const unsigned char* y = (const unsigned char*)b;
+    while (*x != '\0' && plegarCaracter(*x) == plegarCaracter(*y)) {
+        x++;
+        y++;
     }
+    return (int)plegarCaracter(*x) - (int)plegarCaracter(*y);
+}
 
-    encabezadoProductos();
+ClaveOrden claveDeTexto(const char* texto, int id) {
+    ClaveOrden k = { prefijoPlegado(texto), id, texto };
+    return k;
+}
 
-    for (int i = 0; i < tienda->numProductos; i++) {
-        Producto& p = tienda->productos[i];
-        const char* nombreProv = obtenerNombreProveedor(tienda, p.idProveedor);
-        filaProducto(p, nombreProv);
-    }
+ClaveOrden claveDeValor(long long valor, int id) {
+    ClaveOrden k = { claveNumerica(valor), id, nullptr };
+    return k;
+}
 
-    pieProductos();
+template <typename T>
+int compararOrden(const IndiceOrden* ix, Tabla<T>* tabla, const ClaveOrden& k, const NodoOrden& n) {
+    if (k.clave != n.clave)
+        return k.clave < n.clave ? -1 : 1;
+    if (ix->porTexto && k.id != n.id) {
+        int c = compararPlegados(k.texto, (*tabla)[posicionEnTabla(tabla, n.id)].nombre);
+        if (c != 0)
+            return c;
+    }
+    return k.id < n.id ? -1 : (k.id > n.id ? 1 : 0);
+}
 
-    cout << "\nTotal de productos: " << tienda->numProductos << "\n";
+void recontarNodo(IndiceOrden* ix, int t) {
+    NodoOrden& n = ix->nodos[t];
+    n.tam = 1 + ix->nodos[n.izq].tam + ix->nodos[n.der].tam;
 }
 
+unsigned int prioridadAlAzar(IndiceOrden* ix) {
+    // xorshift32: basta con que no se correlacione con el orden de las claves
+    ix->semilla ^= ix->semilla << 13;
+    ix->semilla ^= ix->semilla >> 17;
+    ix->semilla ^= ix->semilla << 5;
+    return ix->semilla;
+}
 
-//========================
-//2.2.6
-//========================
+int nuevoNodoOrden(IndiceOrden* ix, const ClaveOrden& k) {
+    int t = ix->libre;
+    if (t != 0) {
+        ix->libre = ix->nodos[t].izq;
+    } else {
+        if (ix->usados >= ix->capacidad) {
+            int nuevaCap = max(ix->capacidad * 2, 256);
+            NodoOrden* nuevos = new NodoOrden[nuevaCap];
+            for (int i = 0; i < ix->usados; i++)
+                nuevos[i] = ix->nodos[i];
+            delete[] ix->nodos;
+            ix->nodos = nuevos;
+            ix->capacidad = nuevaCap;
+            // El nodo 0 es el vaco: tamao 0 y sin hijos
+            memset(&ix->nodos[0], 0, sizeof(NodoOrden));
+        }
+        t = ix->usados++;
+    }
 
-void eliminarProducto(Tienda* tienda) {
-    int id;
-    cout << "Ingrese el ID del producto a eliminar: ";
-    cin >> id;
+    NodoOrden& n = ix->nodos[t];
+    n.clave = k.clave;
+    n.id = k.id;
+    n.izq = 0;
+    n.der = 0;
+    n.tam = 1;
+    n.prioridad = prioridadAlAzar(ix);
+    return t;
+}
 
-    int index = buscarProductoPorID(tienda, id);
-    if (index == -1) {
-        cout << "ERROR: No existe un producto con ese ID.\n";
+// Separa el subrbol t en los nodos menores que k (*menores) y el resto
+template <typename T>
+void dividirOrden(IndiceOrden* ix, Tabla<T>* tabla, int t, const ClaveOrden& k, int* menores, int* resto) {
+    if (t == 0) {
+        *menores = 0;
+        *resto = 0;
         return;
     }
+    NodoOrden& n = ix->nodos[t];
+    if (compararOrden(ix, tabla, k, n) > 0) {
+        dividirOrden(ix, tabla, n.der, k, &ix->nodos[t].der, resto);
+        *menores = t;
+    } else {
+        dividirOrden(ix, tabla, n.izq, k, menores, &ix->nodos[t].izq);
+        *resto = t;
+    }
+    recontarNodo(ix, t);
+}
 
-    Producto& p = tienda->productos[index];
+// Une a y b, con todas las claves de a menores que las de b
+int unirOrden(IndiceOrden* ix, int a, int b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    if (ix->nodos[a].prioridad > ix->nodos[b].prioridad) {
+        ix->nodos[a].der = unirOrden(ix, ix->nodos[a].der, b);
+        recontarNodo(ix, a);
+        return a;
+    }
+    ix->nodos[b].izq = unirOrden(ix, a, ix->nodos[b].izq);
+    recontarNodo(ix, b);
+    return b;
+}
 
-    cout << "\n=== PRODUCTO A ELIMINAR ===\n";
-    mostrarProducto(p);
+template <typename T>
+void insertarEnOrden(IndiceOrden* ix, Tabla<T>* tabla, const ClaveOrden& k) {
+    int menores, resto;
+    dividirOrden(ix, tabla, ix->raiz, k, &menores, &resto);
+    ix->raiz = unirOrden(ix, unirOrden(ix, menores, nuevoNodoOrden(ix, k)), resto);
+}
 
-    // Advertencia por transacciones asociadas
-    bool tieneTransacciones = false;
-    for (int i = 0; i < tienda->numTransacciones; i++) {
-        if (tienda->transacciones[i].idProducto == id) {
-            tieneTransacciones = true;
-            break;
-        }
+// k tiene que ser la clave con la que se insert: se quita antes de cambiar
+// el registro
+template <typename T>
+int quitarDeSubarbol(IndiceOrden* ix, Tabla<T>* tabla, int t, const ClaveOrden& k) {
+    if (t == 0)
+        return 0;
+    NodoOrden& n = ix->nodos[t];
+    int c = compararOrden(ix, tabla, k, n);
+    if (c == 0) {
+        int unido = unirOrden(ix, n.izq, n.der);
+        n.izq = ix->libre;
+        ix->libre = t;
+        return unido;
     }
+    if (c < 0)
+        n.izq = quitarDeSubarbol(ix, tabla, n.izq, k);
+    else
+        n.der = quitarDeSubarbol(ix, tabla, n.der, k);
+    recontarNodo(ix, t);
+    return t;
+}
 
-    if (tieneTransacciones) {
-        cout << "\nADVERTENCIA: Este producto tiene transacciones asociadas.\n";
+template <typename T>
+void quitarDeOrden(IndiceOrden* ix, Tabla<T>* tabla, const ClaveOrden& k) {
+    ix->raiz = quitarDeSubarbol(ix, tabla, ix->raiz, k);
+}
+
+// Arma el rbol de claves ya ordenadas en O(n): cada nodo nuevo entra por el
+// borde derecho y sube sobre los de menor prioridad (rbol cartesiano)
+void armarDesdeOrdenadas(IndiceOrden* ix, const ClaveOrden* claves, int num) {
+    int* borde = new int[num + 1];
+    int alto = 0;
+    for (int i = 0; i < num; i++) {
+        int t = nuevoNodoOrden(ix, claves[i]);
+        int ultimo = 0;
+        while (alto > 0 && ix->nodos[borde[alto - 1]].prioridad < ix->nodos[t].prioridad) {
+            ultimo = borde[--alto];
+            recontarNodo(ix, ultimo);
+        }
+        ix->nodos[t].izq = ultimo;
+        if (alto > 0)
+            ix->nodos[borde[alto - 1]].der = t;
+        borde[alto++] = t;
     }
+    while (alto > 0)
+        recontarNodo(ix, borde[--alto]);
+    ix->raiz = num > 0 ? borde[0] : 0;
+    delete[] borde;
+}
 
-    if (!confirmar("\nEliminar producto? (S/N): ")) {
-        cout << "Eliminacin cancelada.\n";
-        return;
+template <typename T, typename C>
+void construirIndiceOrden(IndiceOrden* ix, Tabla<T>* tabla, C clave) {
+    liberarIndiceOrden(ix);
+    int num = activosEnTabla(*tabla);
+    ClaveOrden* claves = new ClaveOrden[max(num, 1)];
+    int i = 0;
+    paraCadaActivo(*tabla, [&](T& r, int) { claves[i++] = clave(r); });
+
+    NodoOrden n;
+    sort(claves, claves + num, [&](const ClaveOrden& a, const ClaveOrden& b) {
+        n.clave = b.clave;
+        n.id = b.id;
+        return compararOrden(ix, tabla, a, n) < 0;
+    });
+
+    ix->capacidad = max(num + 1, 256);
+    ix->nodos = new NodoOrden[ix->capacidad];
+    memset(&ix->nodos[0], 0, sizeof(NodoOrden));
+    armarDesdeOrdenadas(ix, claves, num);
+    delete[] claves;
+    ix->construido = true;
+}
+
+// f(registro, posicin) para 'limite' registros (limite < 0 = hasta el
+// final) a partir del nmero 'desde' del orden. Devuelve cuntos visit.
+template <typename T, typename F>
+int paraCadaEnOrden(const IndiceOrden* ix, Tabla<T>& tabla, bool descendente, int desde, int limite, F f) {
+    const NodoOrden* nodos = ix->nodos;
+    auto primero = [&](int t) { return descendente ? nodos[t].der : nodos[t].izq; };
+    auto segundo = [&](int t) { return descendente ? nodos[t].izq : nodos[t].der; };
+
+    // Camino hasta el nodo nmero 'desde', con los nodos que quedan por
+    // visitar despus de l
+    int capPila = 64, alto = 0;
+    int* pila = new int[capPila];
+    auto apilar = [&](int t) {
+        if (alto == capPila) {
+            int* nueva = new int[capPila * 2];
+            for (int i = 0; i < alto; i++)
+                nueva[i] = pila[i];
+            delete[] pila;
+            pila = nueva;
+            capPila *= 2;
+        }
+        pila[alto++] = t;
+    };
+
+    int t = ix->raiz;
+    int k = desde;
+    while (t != 0) {
+        int antes = nodos[primero(t)].tam;
+        if (k < antes) {
+            apilar(t);
+            t = primero(t);
+        } else if (k == antes) {
+            apilar(t);
+            break;
+        } else {
+            k -= antes + 1;
+            t = segundo(t);
+        }
     }
 
-    // Eliminar moviendo elementos
-    for (int i = index; i < tienda->numProductos - 1; i++) {
-        tienda->productos[i] = tienda->productos[i + 1];
+    int visitados = 0;
+    while (alto > 0 && visitados != limite) {
+        int actual = pila[--alto];
+        int pos = posicionEnTabla(&tabla, nodos[actual].id);
+        f(tabla[pos], pos);
+        visitados++;
+        for (t = segundo(actual); t != 0; t = primero(t))
+            apilar(t);
     }
+    delete[] pila;
+    return visitados;
+}
 
-    tienda->numProductos--;
+// Ventana de un listado: en el orden del ndice si hay uno y, si no
+// (orden de registro), en el de la tabla, que solo va ascendente
+template <typename T, typename F>
+int paraCadaEnListado(const IndiceOrden* orden, Tabla<T>& tabla, bool descendente, int desde, int limite, F f) {
+    if (orden == nullptr)
+        return paraCadaActivoEnVentana(tabla, desde, limite, f);
+    return paraCadaEnOrden(orden, tabla, descendente, desde, limite, f);
+}
 
-    cout << "Producto eliminado exitosamente.\n";
+// Clave de un registro en cada ndice de orden
+ClaveOrden claveProducto(const Producto& p, int campo) {
+    switch (campo) {
+    case ORDEN_PRECIO: return claveDeValor(centavosDe(p.precio), p.id);
+    case ORDEN_STOCK: return claveDeValor(p.stock, p.id);
+    case ORDEN_FECHA: return claveDeValor(p.fechaRegistro, p.id);
+    default: return claveDeTexto(p.nombre, p.id);
+    }
 }
 
-//2.3
+// ndices de orden de productos (un bit por campo) en los que cambia la
+// posicin del producto al pasar de a a b
+int ordenesQueCambian(const Producto& a, const Producto& b) {
+    int cambian = 0;
+    if (strcmp(a.nombre, b.nombre) != 0) cambian |= 1 << ORDEN_NOMBRE;
+    if (centavosDe(a.precio) != centavosDe(b.precio)) cambian |= 1 << ORDEN_PRECIO;
+    if (a.stock != b.stock) cambian |= 1 << ORDEN_STOCK;
+    if (a.fechaRegistro != b.fechaRegistro) cambian |= 1 << ORDEN_FECHA;
+    return cambian;
+}
 
-void crearProveedor(Tienda* tienda) {
-    if (!confirmar("Desea registrar un nuevo proveedor? (S/N): "))
-        return;
+IndiceOrden* ordenProductos(Tienda* tienda, int campo) {
+    IndiceOrden* ix = &tienda->ordenProductos[campo - ORDEN_NOMBRE];
+    if (!ix->construido)
+        construirIndiceOrden(ix, &tienda->productos, [campo](const Producto& p) { return claveProducto(p, campo); });
+    return ix;
+}
 
-    Proveedor nuevo;
+template <typename T>
+ClaveOrden claveNombre(const T& r) {
+    return claveDeTexto(r.nombre, r.id);
+}
 
-    // --- RIF ---
-    solicitarString(
-        "Ingrese RIF del proveedor (o CANCELAR): ",
-        nuevo.rif,
-        20,
-        nullptr
-    );
+IndiceOrden* ordenProveedores(Tienda* tienda) {
+    if (!tienda->ordenProveedores.construido)
+        construirIndiceOrden(&tienda->ordenProveedores, &tienda->proveedores, claveNombre<Proveedor>);
+    return &tienda->ordenProveedores;
+}
 
-    if (strcmp(nuevo.rif, "CANCELAR") == 0 || strcmp(nuevo.rif, "0") == 0)
-        return;
+IndiceOrden* ordenClientes(Tienda* tienda) {
+    if (!tienda->ordenClientes.construido)
+        construirIndiceOrden(&tienda->ordenClientes, &tienda->clientes, claveNombre<Cliente>);
+    return &tienda->ordenClientes;
+}
 
-    if (rifDuplicado(tienda, nuevo.rif)) {
-        cout << "ERROR: El RIF '" << nuevo.rif << "' ya est registrado.\n";
-        return;
+// Quita el producto de los ndices de orden de 'ordenes' que estn armados,
+// antes de cambiarlo, y devuelve de cules lo quit para volver a ponerlo
+// en esos despus
+int quitarProductoDeOrden(Tienda* tienda, const Producto& p, int ordenes) {
+    int quitados = 0;
+    for (int campo = ORDEN_NOMBRE; campo <= ORDEN_FECHA; campo++) {
+        IndiceOrden* ix = &tienda->ordenProductos[campo - ORDEN_NOMBRE];
+        if ((ordenes & (1 << campo)) && ix->construido) {
+            quitarDeOrden(ix, &tienda->productos, claveProducto(p, campo));
+            quitados |= 1 << campo;
+        }
     }
+    return quitados;
+}
 
-    // --- Nombre ---
-    solicitarString("Ingrese nombre del proveedor (o CANCELAR): ",
-                    nuevo.nombre, 100);
+void ponerProductoEnOrden(Tienda* tienda, const Producto& p, int ordenes) {
+    for (int campo = ORDEN_NOMBRE; campo <= ORDEN_FECHA; campo++) {
+        IndiceOrden* ix = &tienda->ordenProductos[campo - ORDEN_NOMBRE];
+        if ((ordenes & (1 << campo)) && ix->construido)
+            insertarEnOrden(ix, &tienda->productos, claveProducto(p, campo));
+    }
+}
 
-    if (strcmp(nuevo.nombre, "CANCELAR") == 0 || strcmp(nuevo.nombre, "0") == 0)
-        return;
+//==============
+//columnas calientes de productos
+//==============
 
-    // --- Email ---
-    solicitarString(
-        "Ingrese email del proveedor (o CANCELAR): ",
-        nuevo.email,
-        100,
-        emailValido,
-        "ERROR: El email debe contener '@' y un punto.\n"
-    );
+template <typename T>
+T* crecerColumna(T* columna, int usados, int nuevaCap) {
+    T* nueva = new T[nuevaCap];
+    for (int i = 0; i < usados; i++)
+        nueva[i] = columna[i];
+    delete[] columna;
+    return nueva;
+}
 
-    if (strcmp(nuevo.email, "CANCELAR") == 0 || strcmp(nuevo.email, "0") == 0)
+void iniciarColumnasProductos(ColumnasProductos* col) {
+    col->ids = nullptr;
+    col->idsProveedor = nullptr;
+    col->precios = nullptr;
+    col->stocks = nullptr;
+    col->capacidad = 0;
+    col->construido = false;
+}
+
+void liberarColumnasProductos(ColumnasProductos* col) {
+    delete[] col->ids;
+    delete[] col->idsProveedor;
+    delete[] col->precios;
+    delete[] col->stocks;
+    iniciarColumnasProductos(col);
+}
+
+void reservarColumnasProductos(ColumnasProductos* col, int usados, int minimo) {
+    if (col->capacidad >= minimo) return;
+
+    int nuevaCap = max(col->capacidad * 2, 16);
+    while (nuevaCap < minimo) nuevaCap *= 2;
+
+    col->ids = crecerColumna(col->ids, usados, nuevaCap);
+    col->idsProveedor = crecerColumna(col->idsProveedor, usados, nuevaCap);
+    col->precios = crecerColumna(col->precios, usados, nuevaCap);
+    col->stocks = crecerColumna(col->stocks, usados, nuevaCap);
+    col->capacidad = nuevaCap;
+}
+
+void escribirEnColumnas(ColumnasProductos* col, int index, const Producto& p) {
+    col->ids[index] = p.id;
+    col->idsProveedor[index] = p.idProveedor;
+    col->precios[index] = p.precio;
+    col->stocks[index] = p.stock;
+}
+
+void construirColumnasProductos(Tienda* tienda) {
+    ColumnasProductos* col = &tienda->columnasProductos;
+    reservarColumnasProductos(col, 0, tienda->productos.num);
+    for (int i = 0; i < tienda->productos.num; i++)
+        escribirEnColumnas(col, i, tienda->productos[i]);
+    col->construido = true;
+}
+
+ColumnasProductos* columnasDeProductos(Tienda* tienda) {
+    if (!tienda->columnasProductos.construido)
+        construirColumnasProductos(tienda);
+    return &tienda->columnasProductos;
+}
+
+// Posiciones de los productos activos con stock <= umbral
+int* productosConStockHasta(Tienda* tienda, int umbral, int* numResultados) {
+    const ColumnasProductos* col = columnasDeProductos(tienda);
+    const int* ids = col->ids;
+    const int* stocks = col->stocks;
+    int n = tienda->productos.num;
+
+    *numResultados = 0;
+    for (int i = 0; i < n; i++)
+        *numResultados += (ids[i] > 0) & (stocks[i] <= umbral);
+
+    if (*numResultados == 0)
+        return nullptr;
+
+    int* resultados = new int[*numResultados];
+    int pos = 0;
+    for (int i = 0; i < n; i++) {
+        if (ids[i] > 0 && stocks[i] <= umbral)
+            resultados[pos++] = i;
+    }
+    return resultados;
+}
+
+// Posiciones de los productos activos con precio en [minimo, maximo]
+int* productosEnRangoDePrecio(Tienda* tienda, float minimo, float maximo, int* numResultados) {
+    const ColumnasProductos* col = columnasDeProductos(tienda);
+    const int* ids = col->ids;
+    const float* precios = col->precios;
+    int n = tienda->productos.num;
+
+    *numResultados = 0;
+    for (int i = 0; i < n; i++)
+        *numResultados += (ids[i] > 0) & (precios[i] >= minimo) & (precios[i] <= maximo);
+
+    if (*numResultados == 0)
+        return nullptr;
+
+    int* resultados = new int[*numResultados];
+    int pos = 0;
+    for (int i = 0; i < n; i++) {
+        if (ids[i] > 0 && precios[i] >= minimo && precios[i] <= maximo)
+            resultados[pos++] = i;
+    }
+    return resultados;
+}
+
+//==============
+//anlisis de ventas
+//==============
+
+// Las columnas y los totales diarios se arman con el primer reporte; despus
+// asentarTransacciones los mantiene. Los totales cubren todas las fechas
+// vlidas (1900-2100), as que el da de una lnea se ubica con una resta.
+
+const int FILAS_MIN_POR_HILO = 1 << 16;
+
+void iniciarColumnasTransacciones(ColumnasTransacciones* col) {
+    col->fechas = nullptr;
+    col->esVenta = nullptr;
+    col->idsProducto = nullptr;
+    col->idsRelacionado = nullptr;
+    col->cantidades = nullptr;
+    col->centavos = nullptr;
+    col->num = 0;
+    col->capacidad = 0;
+    col->ordenadas = true;
+    col->dias = nullptr;
+    col->primerDia = 0;
+    col->numDias = 0;
+    col->construido = false;
+}
+
+void liberarColumnasTransacciones(ColumnasTransacciones* col) {
+    delete[] col->fechas;
+    delete[] col->esVenta;
+    delete[] col->idsProducto;
+    delete[] col->idsRelacionado;
+    delete[] col->cantidades;
+    delete[] col->centavos;
+    delete[] col->dias;
+    iniciarColumnasTransacciones(col);
+}
+
+void reservarColumnasTransacciones(ColumnasTransacciones* col, int minimo) {
+    if (col->capacidad >= minimo) return;
+
+    int nuevaCap = max(col->capacidad * 2, 256);
+    while (nuevaCap < minimo) nuevaCap *= 2;
+
+    col->fechas = crecerColumna(col->fechas, col->num, nuevaCap);
+    col->esVenta = crecerColumna(col->esVenta, col->num, nuevaCap);
+    col->idsProducto = crecerColumna(col->idsProducto, col->num, nuevaCap);
+    col->idsRelacionado = crecerColumna(col->idsRelacionado, col->num, nuevaCap);
+    col->cantidades = crecerColumna(col->cantidades, col->num, nuevaCap);
+    col->centavos = crecerColumna(col->centavos, col->num, nuevaCap);
+    col->capacidad = nuevaCap;
+}
+
+void sumarMovimiento(Movimiento* m, int cantidad, long long centavos) {
+    m->lineas++;
+    m->unidades += cantidad;
+    m->centavos += centavos;
+}
+
+void agregarEnColumnas(ColumnasTransacciones* col, const Transaccion& t) {
+    reservarColumnasTransacciones(col, col->num + 1);
+
+    int i = col->num++;
+    bool venta = strcmp(t.tipo, "VENTA") == 0;
+    col->fechas[i] = t.fecha;
+    col->esVenta[i] = venta;
+    col->idsProducto[i] = t.idProducto;
+    col->idsRelacionado[i] = t.idRelacionado;
+    col->cantidades[i] = t.cantidad;
+    col->centavos[i] = centavosDe(t.total);
+    if (i > 0 && t.fecha < col->fechas[i - 1])
+        col->ordenadas = false;
+
+    int dia = t.fecha - col->primerDia;
+    if (dia >= 0 && dia < col->numDias) {
+        TotalesDia* d = &col->dias[dia];
+        sumarMovimiento(venta ? &d->ventas : &d->compras, t.cantidad, col->centavos[i]);
+    }
+}
+
+void construirColumnasTransacciones(Tienda* tienda) {
+    ColumnasTransacciones* col = &tienda->columnasTransacciones;
+    liberarColumnasTransacciones(col);
+
+    col->primerDia = diasDesdeEpoca(1900, 1, 1);
+    col->numDias = diasDesdeEpoca(2100, 12, 31) - col->primerDia + 1;
+    col->dias = new TotalesDia[col->numDias];
+    memset(col->dias, 0, col->numDias * sizeof(TotalesDia));
+
+    reservarColumnasTransacciones(col, tienda->transacciones.num);
+    for (int i = 0; i < tienda->transacciones.num; i++)
+        agregarEnColumnas(col, tienda->transacciones[i]);
+    col->construido = true;
+}
+
+ColumnasTransacciones* columnasDeTransacciones(Tienda* tienda) {
+    if (!tienda->columnasTransacciones.construido)
+        construirColumnasTransacciones(tienda);
+    return &tienda->columnasTransacciones;
+}
+
+// Totales de un da (todo en cero si la fecha no es vlida)
+TotalesDia totalesDelDia(Tienda* tienda, int fecha) {
+    const ColumnasTransacciones* col = columnasDeTransacciones(tienda);
+    TotalesDia vacio;
+    memset(&vacio, 0, sizeof(vacio));
+    int dia = fecha - col->primerDia;
+    return dia >= 0 && dia < col->numDias ? col->dias[dia] : vacio;
+}
+
+struct TotalAgrupado {
+    int clave;
+    Movimiento total;
+};
+
+// Filas [inicio, fin) que agrupa un hilo en su propio arreglo de totales
+struct TrozoAgrupacion {
+    const ColumnasTransacciones* col;
+    const int* claves;
+    int numClaves;
+    int desde, hasta;          // fechas
+    unsigned char venta;
+    int inicio, fin;
+    Movimiento* totales;       // totales[clave]
+};
+
+void agruparTrozo(TrozoAgrupacion* t) {
+    const int* fechas = t->col->fechas;
+    const unsigned char* esVenta = t->col->esVenta;
+    const int* cantidades = t->col->cantidades;
+    const long long* centavos = t->col->centavos;
+
+    for (int i = t->inicio; i < t->fin; i++) {
+        if (fechas[i] < t->desde || fechas[i] > t->hasta || esVenta[i] != t->venta)
+            continue;
+        int clave = t->claves[i];
+        if (clave > 0 && clave < t->numClaves)
+            sumarMovimiento(&t->totales[clave], cantidades[i], centavos[i]);
+    }
+}
+
+bool menorClave(const TotalAgrupado& a, const TotalAgrupado& b) {
+    return a.clave < b.clave;
+}
+
+TotalAgrupado* agruparOrdenando(const ColumnasTransacciones* col, int inicio, int fin, int desde,
+                                int hasta, bool ventas, const int* claves, int numClaves,
+                                int* numGrupos) {
+    TotalAgrupado* grupos = new TotalAgrupado[max(fin - inicio, 1)];
+    int num = 0;
+    for (int i = inicio; i < fin; i++) {
+        if (col->fechas[i] < desde || col->fechas[i] > hasta || col->esVenta[i] != ventas ||
+            claves[i] <= 0 || claves[i] >= numClaves)
+            continue;
+        TotalAgrupado& g = grupos[num++];
+        g.clave = claves[i];
+        g.total.lineas = 1;
+        g.total.unidades = col->cantidades[i];
+        g.total.centavos = col->centavos[i];
+    }
+    sort(grupos, grupos + num, menorClave);
+
+    // Juntar las filas de la misma clave
+    *numGrupos = 0;
+    for (int i = 0; i < num; i++) {
+        if (*numGrupos > 0 && grupos[*numGrupos - 1].clave == grupos[i].clave) {
+            Movimiento& m = grupos[*numGrupos - 1].total;
+            m.lineas += grupos[i].total.lineas;
+            m.unidades += grupos[i].total.unidades;
+            m.centavos += grupos[i].total.centavos;
+        } else {
+            grupos[(*numGrupos)++] = grupos[i];
+        }
+    }
+    if (*numGrupos == 0) {
+        delete[] grupos;
+        return nullptr;
+    }
+    return grupos;
+}
+
+// Agrupa por la columna 'clave' (ids menores que numClaves) las ventas o las
+// compras con fecha en [desde, hasta], repartiendo las filas entre hilos.
+// Devuelve los grupos con movimiento ordenados por clave.
+TotalAgrupado* agruparTransacciones(Tienda* tienda, int desde, int hasta, bool ventas,
+                                    int* ColumnasTransacciones::*clave, int numClaves,
+                                    int* numGrupos) {
+    const ColumnasTransacciones* col = columnasDeTransacciones(tienda);
+    numClaves = max(numClaves, 1);
+
+    // Con las fechas en orden basta recorrer las filas del rango
+    int inicio = 0, fin = col->num;
+    if (col->ordenadas) {
+        inicio = lower_bound(col->fechas, col->fechas + col->num, desde) - col->fechas;
+        fin = max(inicio, (int)(upper_bound(col->fechas, col->fechas + col->num, hasta) - col->fechas));
+    }
+    int filas = fin - inicio;
+
+    // Pocas filas para tantas claves: ordenar las filas sale ms barato que
+    // limpiar y recorrer un arreglo de numClaves totales
+    if ((long long)filas * 4 < numClaves)
+        return agruparOrdenando(col, inicio, fin, desde, hasta, ventas, col->*clave, numClaves, numGrupos);
+
+    // Cada hilo suma en un arreglo propio de numClaves totales; solo conviene
+    // si recorre bastantes ms filas que las que despus hay que combinar
+    int numHilos = thread::hardware_concurrency();
+    if (numHilos < 1) numHilos = 1;
+    if (numHilos > 16) numHilos = 16;
+    numHilos = max(1, min(numHilos, filas / max(numClaves, FILAS_MIN_POR_HILO)));
+
+    TrozoAgrupacion* trozos = new TrozoAgrupacion[numHilos];
+    for (int h = 0; h < numHilos; h++) {
+        TrozoAgrupacion& t = trozos[h];
+        t.col = col;
+        t.claves = col->*clave;
+        t.numClaves = numClaves;
+        t.desde = desde;
+        t.hasta = hasta;
+        t.venta = ventas;
+        t.inicio = inicio + (int)((long long)filas * h / numHilos);
+        t.fin = inicio + (int)((long long)filas * (h + 1) / numHilos);
+        t.totales = new Movimiento[numClaves];
+        memset(t.totales, 0, numClaves * sizeof(Movimiento));
+    }
+
+    if (numHilos == 1) {
+        agruparTrozo(&trozos[0]);
+    } else {
+        thread* hilos = new thread[numHilos];
+        for (int h = 0; h < numHilos; h++)
+            hilos[h] = thread(agruparTrozo, &trozos[h]);
+        for (int h = 0; h < numHilos; h++)
+            hilos[h].join();
+        delete[] hilos;
+    }
+
+    Movimiento* totales = trozos[0].totales;
+    for (int h = 1; h < numHilos; h++) {
+        for (int k = 0; k < numClaves; k++) {
+            totales[k].lineas += trozos[h].totales[k].lineas;
+            totales[k].unidades += trozos[h].totales[k].unidades;
+            totales[k].centavos += trozos[h].totales[k].centavos;
+        }
+        delete[] trozos[h].totales;
+    }
+    delete[] trozos;
+
+    *numGrupos = 0;
+    for (int k = 0; k < numClaves; k++)
+        *numGrupos += totales[k].lineas > 0;
+
+    TotalAgrupado* grupos = nullptr;
+    if (*numGrupos > 0) {
+        grupos = new TotalAgrupado[*numGrupos];
+        int pos = 0;
+        for (int k = 0; k < numClaves; k++) {
+            if (totales[k].lineas == 0) continue;
+            grupos[pos].clave = k;
+            grupos[pos].total = totales[k];
+            pos++;
+        }
+    }
+    delete[] totales;
+    return grupos;
+}
+
+bool masUnidades(const TotalAgrupado& a, const TotalAgrupado& b) {
+    if (a.total.unidades != b.total.unidades) return a.total.unidades > b.total.unidades;
+    return a.clave < b.clave;
+}
+
+bool masIngresos(const TotalAgrupado& a, const TotalAgrupado& b) {
+    if (a.total.centavos != b.total.centavos) return a.total.centavos > b.total.centavos;
+    return a.clave < b.clave;
+}
+
+// Los 'n' productos ms vendidos en [desde, hasta], por unidades o por ingresos
+TotalAgrupado* productosMasVendidos(Tienda* tienda, int desde, int hasta, int n,
+                                    bool porIngresos, int* numResultados) {
+    TotalAgrupado* grupos = agruparTransacciones(tienda, desde, hasta, true,
+                                                 &ColumnasTransacciones::idsProducto,
+                                                 tienda->siguienteIdProducto, numResultados);
+    int k = min(max(n, 0), *numResultados);
+    partial_sort(grupos, grupos + k, grupos + *numResultados, porIngresos ? masIngresos : masUnidades);
+    *numResultados = k;
+    return grupos;
+}
+
+// Compras a cada proveedor en [desde, hasta], ordenadas por id de proveedor
+TotalAgrupado* comprasPorProveedor(Tienda* tienda, int desde, int hasta, int* numResultados) {
+    return agruparTransacciones(tienda, desde, hasta, false, &ColumnasTransacciones::idsRelacionado,
+                                tienda->siguienteIdProveedor, numResultados);
+}
+
+void iniciarIndicesTienda(Tienda* tienda) {
+    iniciarIndiceClave(&tienda->indiceCodigos);
+    iniciarIndiceClave(&tienda->indiceRifs);
+    iniciarIndiceClave(&tienda->indiceCedulas);
+    iniciarIndiceTrigramas(&tienda->trigramasNombreProducto);
+    iniciarIndiceTrigramas(&tienda->trigramasCodigoProducto);
+    iniciarIndiceTrigramas(&tienda->trigramasNombreProveedor);
+    iniciarIndiceTrigramas(&tienda->trigramasNombreCliente);
+    iniciarIndiceProveedorProductos(&tienda->productosPorProveedor);
+    iniciarColumnasProductos(&tienda->columnasProductos);
+    iniciarIndiceFechas(&tienda->fechasProductos);
+    iniciarIndiceFechas(&tienda->fechasTransacciones);
+    iniciarAgregados(&tienda->agregados);
+    iniciarIndiceReposicion(&tienda->reposicion);
+    for (int i = 0; i < NUM_ORDENES_PRODUCTO; i++)
+        iniciarIndiceOrden(&tienda->ordenProductos[i], i == ORDEN_NOMBRE - ORDEN_NOMBRE);
+    iniciarIndiceOrden(&tienda->ordenProveedores, true);
+    iniciarIndiceOrden(&tienda->ordenClientes, true);
+    iniciarColumnasTransacciones(&tienda->columnasTransacciones);
+}
+
+void liberarIndicesTienda(Tienda* tienda) {
+    liberarIndiceClave(&tienda->indiceCodigos);
+    liberarIndiceClave(&tienda->indiceRifs);
+    liberarIndiceClave(&tienda->indiceCedulas);
+    liberarIndiceTrigramas(&tienda->trigramasNombreProducto);
+    liberarIndiceTrigramas(&tienda->trigramasCodigoProducto);
+    liberarIndiceTrigramas(&tienda->trigramasNombreProveedor);
+    liberarIndiceTrigramas(&tienda->trigramasNombreCliente);
+    liberarIndiceProveedorProductos(&tienda->productosPorProveedor);
+    liberarColumnasProductos(&tienda->columnasProductos);
+    liberarIndiceFechas(&tienda->fechasProductos);
+    liberarIndiceFechas(&tienda->fechasTransacciones);
+    liberarAgregados(&tienda->agregados);
+    liberarIndiceReposicion(&tienda->reposicion);
+    for (int i = 0; i < NUM_ORDENES_PRODUCTO; i++)
+        liberarIndiceOrden(&tienda->ordenProductos[i]);
+    liberarIndiceOrden(&tienda->ordenProveedores);
+    liberarIndiceOrden(&tienda->ordenClientes);
+    liberarColumnasTransacciones(&tienda->columnasTransacciones);
+}
+
+int buscarProveedorPorID(Tienda* tienda, int id);
+
+bool existeProveedor(Tienda* tienda, int idProveedor) {
+    return buscarProveedorPorID(tienda, idProveedor) != -1;
+}
+
+bool codigoProductoDuplicado(Tienda* tienda, const char* codigo, int idIgnorar = -1) {
+    int id = idPorCodigo(tienda, codigo);
+    return id != -1 && id != idIgnorar;
+}
+
+bool validarFecha(const char* fecha) {
+    int dias;
+    return parsearFecha(fecha, &dias);
+}
+
+const char* obtenerNombreProveedor(Tienda* tienda, int idProveedor) {
+    int index = buscarProveedorPorID(tienda, idProveedor);
+    if (index == -1)
+        return "Desconocido";
+    return tienda->proveedores[index].nombre;
+}
+
+void solicitarString(const char* mensaje, char* destino, int maxLen,
+                     bool (*validador)(const char*) = nullptr,
+                     const char* mensajeError = "ERROR: Valor invlido.\n") 
+{
+    while (true) {
+        cout << mensaje;
+        cin.getline(destino, maxLen);
+
+        if (strlen(destino) == 0) {
+            cout << "ERROR: No puede estar vaco.\n";
+            continue;
+        }
+
+        if (validador != nullptr && !validador(destino)) {
+            cout << mensajeError;
+            continue;
+        }
+
+        break;
+    }
+}
+
+bool sinEspacios(const char* texto) {
+    for (int i = 0; texto[i] != '\0'; i++)
+        if (texto[i] == ' ')
+            return false;
+    return true;
+}
+
+
+bool emailValido(const char* email) {
+    const char* at = strchr(email, '@');
+    if (!at) return false;
+
+    const char* punto = strchr(at, '.');
+    if (!punto) return false;
+
+    return true;
+}
+
+bool rifDuplicado(Tienda* tienda, const char* rif, int idIgnorar = -1) {
+    int id = idPorRif(tienda, rif);
+    return id != -1 && id != idIgnorar;
+}
+
+bool clienteDuplicado(Tienda* tienda, const char* cedula, int idIgnorar = -1) {
+    int id = idPorCedula(tienda, cedula);
+    return id != -1 && id != idIgnorar;
+}
+
+bool confirmar(const char* mensaje) {
+    char op[10];
+    cout << mensaje;
+    cin >> op;
+    cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // <- clave
+
+    return toupper(op[0]) == 'S';
+}
+
+
+int solicitarEnteroPositivo(const char* mensaje) {
+    int valor;
+    cout << mensaje;
+    cin >> valor;
+
+    while (valor <= 0) {
+        cout << "ERROR: Debe ser mayor a 0.\n";
+        cout << mensaje;
+        cin >> valor;
+    }
+    return valor;
+}
+int solicitarEnteroNoNegativo(const char* mensaje) {
+    int valor;
+    cout << mensaje;
+    cin >> valor;
+
+    while (valor < 0) {
+        cout << "ERROR: Debe ser >= 0.\n";
+        cout << mensaje;
+        cin >> valor;
+    }
+    return valor;
+}
+
+// Pide una fecha YYYY-MM-DD y la devuelve en das
+int solicitarFecha(const char* mensaje) {
+    char texto[LARGO_FECHA + 20];
+    solicitarString(mensaje, texto, sizeof(texto), validarFecha,
+                    "ERROR: Fecha invlida (YYYY-MM-DD).\n");
+    int dias = 0;
+    parsearFecha(texto, &dias);
+    return dias;
+}
+
+// Pregunta por qu campo ordenar un listado (precio, stock y fecha solo si
+// es de productos) y, salvo en el orden de registro, si va de mayor a menor
+void solicitarOrden(bool deProductos, int* campo, bool* descendente) {
+    cout << "Ordenar por: 1. Registro  2. Nombre";
+    if (deProductos)
+        cout << "  3. Precio  4. Stock  5. Fecha";
+    cout << "\nOpcin: ";
+
+    int opcion;
+    cin >> opcion;
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        opcion = 1;
+    }
+    int ultima = deProductos ? ORDEN_FECHA + 1 : ORDEN_NOMBRE + 1;
+    if (opcion < 1 || opcion > ultima) opcion = 1;
+
+    *campo = opcion - 1;
+    *descendente = *campo != ORDEN_REGISTRO && confirmar("De mayor a menor? (S/N): ");
+}
+
+
+int buscarProductoPorID(Tienda* tienda, int id) {
+    return posicionEnTabla(&tienda->productos, id);
+}
+
+bool existeProducto(Tienda* tienda, int id) {
+    return buscarProductoPorID(tienda, id) != -1;
+}
+
+int* buscarProductosPorNombre(Tienda* tienda, const char* nombre, int* numResultados) {
+    *numResultados = 0;
+
+    // Con el ndice de trigramas solo se revisan los candidatos
+    int numCandidatos;
+    int* candidatos = candidatosEnTienda(tienda, &tienda->trigramasNombreProducto,
+                                         construirTrigramasNombreProducto,
+                                         tienda->productos.num, nombre, &numCandidatos);
+    PatronTexto patron;
+    prepararPatron(&patron, nombre);
+    if (numCandidatos >= 0) {
+        int* resultados = nullptr;
+        for (int i = 0; i < numCandidatos; i++) {
+            int index = buscarProductoPorID(tienda, candidatos[i]);
+            if (index == -1 || !contieneTexto(tienda->productos[index].nombre,
+                                              sizeof(Producto::nombre), &patron))
+                continue;
+            if (resultados == nullptr)
+                resultados = new int[numCandidatos];
+            resultados[(*numResultados)++] = index;
+        }
+        delete[] candidatos;
+        return resultados;
+    }
+
+    return filtrarPorTexto(tienda->productos, &Producto::nombre, &patron, numResultados);
+}
+
+void mostrarProducto(const Producto& p) {
+    cout << "Cdigo: " << p.codigo << endl;
+    cout << "Nombre: " << p.nombre << endl;
+    cout << "Descripcin: " << p.descripcion << endl;
+    cout << "Proveedor ID: " << p.idProveedor << endl;
+    cout << "Precio: " << p.precio << endl;
+    cout << "Stock: " << p.stock << endl;
+    cout << "Stock mnimo: " << p.stockMinimo << endl;
+    char fecha[LARGO_FECHA];
+    formatearFecha(p.fechaRegistro, fecha);
+    cout << "Fecha: " << fecha << endl;
+}
+
+//==============
+//archivos
+//==============
+
+// Mapea un archivo completo en modo copy-on-write: lo que se escriba en la
+// vista queda en memoria privada del proceso y nunca llega al archivo.
+char* mapearArchivo(const char* ruta, long long* tam) {
+#ifdef _WIN32
+    HANDLE archivo = CreateFileA(ruta, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (archivo == INVALID_HANDLE_VALUE) return nullptr;
+
+    LARGE_INTEGER tamArchivo;
+    if (!GetFileSizeEx(archivo, &tamArchivo) || tamArchivo.QuadPart == 0) {
+        CloseHandle(archivo);
+        return nullptr;
+    }
+
+    HANDLE mapeo = CreateFileMappingA(archivo, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(archivo);
+    if (mapeo == nullptr) return nullptr;
+
+    char* vista = (char*)MapViewOfFile(mapeo, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapeo); // la vista mantiene vivo el mapeo
+    if (vista == nullptr) return nullptr;
+
+    *tam = tamArchivo.QuadPart;
+    return vista;
+#else
+    int fd = open(ruta, O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* vista = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (vista == MAP_FAILED) return nullptr;
+
+    *tam = info.st_size;
+    return (char*)vista;
+#endif
+}
+
+void desmapearArchivo(char* vista, long long tam) {
+#ifdef _WIN32
+    (void)tam;
+    UnmapViewOfFile(vista);
+#else
+    munmap(vista, tam);
+#endif
+}
+
+// Vaca los buffers de C y del sistema operativo hasta el disco
+bool sincronizarArchivo(FILE* f) {
+    if (fflush(f) != 0) return false;
+#ifdef _WIN32
+    return FlushFileBuffers((HANDLE)_get_osfhandle(_fileno(f))) != 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+void cerrarVistaSnapshot(Tienda* tienda) {
+    if (tienda->vistaSnapshot == nullptr) return;
+
+    desmapearArchivo(tienda->vistaSnapshot, tienda->tamVistaSnapshot);
+    tienda->vistaSnapshot = nullptr;
+    tienda->tamVistaSnapshot = 0;
+}
+
+// Los arrays de un snapshot mapeado no salen de new[]: no se liberan con delete[]
+bool enVistaSnapshot(Tienda* tienda, const void* ptr) {
+    if (tienda->vistaSnapshot == nullptr) return false;
+    const char* p = (const char*)ptr;
+    return p >= tienda->vistaSnapshot &&
+           p <  tienda->vistaSnapshot + tienda->tamVistaSnapshot;
+}
+
+
+
+
+//================
+//tablas de texto
+//================
+
+// Las tablas se arman en un bfer grande y se escriben con pocos fwrite;
+// los bordes salen de los anchos de columna, no de cadenas fijas.
+const int TAM_BUFFER_TABLA = 1 << 18;
+const int FILAS_POR_PAGINA = 50;
+const char BORDE_VERTICAL[] = "";
+
+struct ColumnaTabla {
+    const char* titulo;
+    int ancho;
+};
+
+struct SalidaTabla {
+    FILE* destino;
+    char* buffer;
+    int usado;
+    const ColumnaTabla* columnas;
+    int numColumnas;
+    int anchoInterior;         // Entre los dos bordes verticales de afuera
+    bool error;
+};
+
+void vaciarSalidaTabla(SalidaTabla* s) {
+    if (s->usado > 0 && fwrite(s->buffer, 1, s->usado, s->destino) != (size_t)s->usado)
+        s->error = true;
+    s->usado = 0;
+}
+
+void escribirBytes(SalidaTabla* s, const char* datos, int len) {
+    if (s->usado + len > TAM_BUFFER_TABLA) vaciarSalidaTabla(s);
+    memcpy(s->buffer + s->usado, datos, len);
+    s->usado += len;
+}
+
+void repetirCaracter(SalidaTabla* s, char c, int veces) {
+    if (s->usado + veces > TAM_BUFFER_TABLA) vaciarSalidaTabla(s);
+    memset(s->buffer + s->usado, c, veces);
+    s->usado += veces;
+}
+
+void escribirBorde(SalidaTabla* s) {
+    escribirBytes(s, BORDE_VERTICAL, sizeof(BORDE_VERTICAL) - 1);
+}
+
+void iniciarSalidaTabla(SalidaTabla* s, FILE* destino, const ColumnaTabla* columnas, int numColumnas) {
+    // Lo que ya est en cout tiene que salir antes que la tabla
+    cout.flush();
+    s->destino = destino;
+    s->buffer = new char[TAM_BUFFER_TABLA];
+    s->usado = 0;
+    s->columnas = columnas;
+    s->numColumnas = numColumnas;
+    s->anchoInterior = numColumnas - 1;
+    for (int i = 0; i < numColumnas; i++)
+        s->anchoInterior += columnas[i].ancho + 2;
+    s->error = false;
+}
+
+// Vaca lo pendiente y libera el bfer. Devuelve false si fall alguna escritura.
+bool terminarSalidaTabla(SalidaTabla* s) {
+    vaciarSalidaTabla(s);
+    if (fflush(s->destino) != 0) s->error = true;
+    delete[] s->buffer;
+    s->buffer = nullptr;
+    return !s->error;
+}
+
+// Celda con el texto recortado o rellenado al ancho de la columna
+void celdaTexto(SalidaTabla* s, int columna, const char* texto) {
+    int ancho = s->columnas[columna].ancho;
+    int len = 0;
+    while (len < ancho && texto[len] != '\0') len++;
+    if (columna == 0) escribirBorde(s);
+    escribirBytes(s, " ", 1);
+    escribirBytes(s, texto, len);
+    repetirCaracter(s, ' ', ancho - len + 1);
+    escribirBorde(s);
+    if (columna == s->numColumnas - 1) escribirBytes(s, "\n", 1);
+}
+
+// Escribe los dgitos de 'valor' terminando en 'fin' (hacia atrs) y
+// devuelve dnde empiezan. snprintf por celda era lo ms caro del listado.
+char* digitosHaciaAtras(char* fin, unsigned long long valor) {
+    do {
+        *--fin = (char)('0' + valor % 10);
+        valor /= 10;
+    } while (valor != 0);
+    return fin;
+}
+
+void celdaEntero(SalidaTabla* s, int columna, long long valor) {
+    char texto[24];
+    texto[23] = '\0';
+    unsigned long long magnitud = valor < 0 ? 0ULL - (unsigned long long)valor : valor;
+    char* inicio = digitosHaciaAtras(texto + 23, magnitud);
+    if (valor < 0) *--inicio = '-';
+    celdaTexto(s, columna, inicio);
+}
+
+// Un monto en centavos, con dos decimales
+void celdaCentavos(SalidaTabla* s, int columna, long long centavos) {
+    char texto[32];
+    texto[31] = '\0';
+    unsigned long long magnitud = centavos < 0 ? 0ULL - (unsigned long long)centavos : centavos;
+    char* inicio = texto + 31;
+    *--inicio = (char)('0' + magnitud % 10);
+    *--inicio = (char)('0' + magnitud / 10 % 10);
+    *--inicio = '.';
+    inicio = digitosHaciaAtras(inicio, magnitud / 100);
+    if (centavos < 0) *--inicio = '-';
+    celdaTexto(s, columna, inicio);
+}
+
+// Con dos decimales, redondeando al centavo
+void celdaPrecio(SalidaTabla* s, int columna, float valor) {
+    if (valor >= 1e15f || valor <= -1e15f) {
+        char texto[64];
+        snprintf(texto, sizeof(texto), "%.2f", valor);
+        celdaTexto(s, columna, texto);
+        return;
+    }
+    celdaCentavos(s, columna, centavosDe(valor));
+}
+
+// Lnea de arriba/abajo (+---+) o interior (---); con cruces marca las columnas
+void lineaTabla(SalidaTabla* s, bool exterior, bool cruces) {
+    if (exterior) escribirBytes(s, "+", 1); else escribirBorde(s);
+    if (cruces) {
+        for (int i = 0; i < s->numColumnas; i++) {
+            if (i > 0) escribirBytes(s, "+", 1);
+            repetirCaracter(s, '-', s->columnas[i].ancho + 2);
+        }
+    } else {
+        repetirCaracter(s, '-', s->anchoInterior);
+    }
+    if (exterior) escribirBytes(s, "+\n", 2); else { escribirBorde(s); escribirBytes(s, "\n", 1); }
+}
+
+void encabezadoTabla(SalidaTabla* s, const char* titulo) {
+    lineaTabla(s, true, false);
+    int len = (int)strlen(titulo);
+    int izquierda = (s->anchoInterior - len) / 2;
+    escribirBorde(s);
+    repetirCaracter(s, ' ', izquierda);
+    escribirBytes(s, titulo, len);
+    repetirCaracter(s, ' ', s->anchoInterior - len - izquierda);
+    escribirBorde(s);
+    escribirBytes(s, "\n", 1);
+    lineaTabla(s, false, false);
+    for (int i = 0; i < s->numColumnas; i++)
+        celdaTexto(s, i, s->columnas[i].titulo);
+    lineaTabla(s, false, true);
+}
+
+void pieTabla(SalidaTabla* s) {
+    lineaTabla(s, true, false);
+}
+
+// Muestra la tabla de a FILAS_POR_PAGINA filas. Solo se recorre la pgina
+// pedida, as que el costo no depende del tamao de la tabla.
+// dibujar(tienda, destino, desde, limite) dibuja en 'destino' la tabla con
+// 'limite' registros activos a partir del nmero 'desde' (limite < 0 = todos).
+template <typename F>
+void mostrarPorPaginas(Tienda* tienda, F dibujar, int total, const char* nombre) {
+    int paginas = (total + FILAS_POR_PAGINA - 1) / FILAS_POR_PAGINA;
+    int pagina = 1;
+    while (true) {
+        dibujar(tienda, stdout, (pagina - 1) * FILAS_POR_PAGINA, FILAS_POR_PAGINA);
+        cout << "\nTotal de " << nombre << ": " << total;
+        if (paginas > 1)
+            cout << " | Pgina " << pagina << " de " << paginas;
+        cout << "\n";
+        if (paginas == 1) return;
+
+        cout << "Pgina a mostrar (0 para salir): ";
+        cin >> pagina;
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            return;
+        }
+        if (pagina <= 0) return;
+        if (pagina > paginas) pagina = paginas;
+    }
+}
+
+//================
+//tabla producto
+//================
+
+const ColumnaTabla COLUMNAS_PRODUCTOS[] = {
+    {"ID", 6}, {"Cdigo", 12}, {"Nombre", 24}, {"Proveedor", 18},
+    {"Precio", 10}, {"Stock", 7}, {"Fecha", 10}
+};
+
+void filaProducto(SalidaTabla* s, const Producto& p, const char* nombreProv) {
+    celdaEntero(s, 0, p.id);
+    celdaTexto(s, 1, p.codigo);
+    celdaTexto(s, 2, p.nombre);
+    celdaTexto(s, 3, nombreProv);
+    celdaPrecio(s, 4, p.precio);
+    celdaEntero(s, 5, p.stock);
+    char fecha[LARGO_FECHA];
+    formatearFecha(p.fechaRegistro, fecha);
+    celdaTexto(s, 6, fecha);
+}
+
+int buscarProveedorPorID(Tienda* tienda, int id) {
+    return posicionEnTabla(&tienda->proveedores, id);
+}
+
+int buscarProveedorPorRIF(Tienda* tienda, const char* rif) {
+    return buscarProveedorPorID(tienda, idPorRif(tienda, rif));
+}
+
+int buscarProveedorPorNombre(Tienda* tienda, const char* nombre) {
+    int numCandidatos;
+    int* candidatos = candidatosEnTienda(tienda, &tienda->trigramasNombreProveedor,
+                                         construirTrigramasNombreProveedor,
+                                         tienda->proveedores.num, nombre, &numCandidatos);
+    PatronTexto patron;
+    prepararPatron(&patron, nombre);
+    if (numCandidatos >= 0) {
+        // Los ids salen ordenados: el primero que coincide es el de menor posicin
+        int encontrado = -1;
+        for (int i = 0; i < numCandidatos && encontrado == -1; i++) {
+            int index = buscarProveedorPorID(tienda, candidatos[i]);
+            if (index != -1 && contieneTexto(tienda->proveedores[index].nombre,
+                                             sizeof(Proveedor::nombre), &patron))
+                encontrado = index;
+        }
+        delete[] candidatos;
+        return encontrado;
+    }
+
+    return primeroPorTexto(tienda->proveedores, &Proveedor::nombre, &patron);
+}
+
+void mostrarProveedor(const Proveedor& p) {
+    cout << "\n=== PROVEEDOR ENCONTRADO ===\n";
+    cout << "ID: " << p.id << endl;
+    cout << "RIF: " << p.rif << endl;
+    cout << "Nombre: " << p.nombre << endl;
+    cout << "Email: " << p.email << endl;
+    cout << "Telfono: " << p.telefono << endl;
+}
+
+//================
+// tabla proveedor
+//================
+
+const ColumnaTabla COLUMNAS_PROVEEDORES[] = {
+    {"ID", 6}, {"Nombre", 24}, {"RIF", 16}, {"Telfono", 20}
+};
+
+void filaProveedor(SalidaTabla* s, const Proveedor& p) {
+    celdaEntero(s, 0, p.id);
+    celdaTexto(s, 1, p.nombre);
+    celdaTexto(s, 2, p.rif);
+    celdaTexto(s, 3, p.telefono);
+}
+
+int buscarClientePorID(Tienda* tienda, int id) {
+    return posicionEnTabla(&tienda->clientes, id);
+}
+
+int buscarClientePorCedula(Tienda* tienda, const char* cedula) {
+    return buscarClientePorID(tienda, idPorCedula(tienda, cedula));
+}
+
+int buscarClientePorNombre(Tienda* tienda, const char* nombre) {
+    int numCandidatos;
+    int* candidatos = candidatosEnTienda(tienda, &tienda->trigramasNombreCliente,
+                                         construirTrigramasNombreCliente,
+                                         tienda->clientes.num, nombre, &numCandidatos);
+    PatronTexto patron;
+    prepararPatron(&patron, nombre);
+    if (numCandidatos >= 0) {
+        int encontrado = -1;
+        for (int i = 0; i < numCandidatos && encontrado == -1; i++) {
+            int index = buscarClientePorID(tienda, candidatos[i]);
+            if (index != -1 && contieneTexto(tienda->clientes[index].nombre,
+                                             sizeof(Cliente::nombre), &patron))
+                encontrado = index;
+        }
+        delete[] candidatos;
+        return encontrado;
+    }
+
+    return primeroPorTexto(tienda->clientes, &Cliente::nombre, &patron);
+}
+
+void mostrarCliente(const Cliente& c) {
+    cout << "\n=== CLIENTE ENCONTRADO ===\n";
+    cout << "ID: " << c.id << endl;
+    cout << "Cdula/RIF: " << c.cedula << endl;
+    cout << "Nombre: " << c.nombre << endl;
+    cout << "Email: " << c.email << endl;
+    cout << "Telfono: " << c.telefono << endl;
+    cout << "Direccin: " << c.direccion << endl;
+}
+
+//==============
+//tabla clientes
+//==============
+
+const ColumnaTabla COLUMNAS_CLIENTES[] = {
+    {"ID", 6}, {"Nombre", 22}, {"Cdula/RIF", 14}, {"Telfono", 16}, {"Email", 26}
+};
+
+void filaCliente(SalidaTabla* s, const Cliente& c) {
+    celdaEntero(s, 0, c.id);
+    celdaTexto(s, 1, c.nombre);
+    celdaTexto(s, 2, c.cedula);
+    celdaTexto(s, 3, c.telefono);
+    celdaTexto(s, 4, c.email);
+}
+
+//===============
+//2.1 inicializar
+//===============
+
+void inicializarTienda(Tienda* tienda, const char* nombre, const char* rif){
+
+    strcpy(tienda->nombre, nombre);
+    strcpy(tienda->rif, rif);
+    
+    // Tablas vacas: los segmentos se reservan con la primera alta
+    iniciarTabla(&tienda->productos);
+    iniciarTabla(&tienda->proveedores);
+    iniciarTabla(&tienda->clientes);
+    iniciarTabla(&tienda->transacciones);
+
+    // IDs 
+    tienda->siguienteIdProducto = 1;
+    tienda->siguienteIdProveedor = 1;
+    tienda->siguienteIdCliente = 1;
+    tienda->siguienteIdTransaccion = 1;
+
+    tienda->vistaSnapshot = nullptr;
+    tienda->tamVistaSnapshot = 0;
+
+    tienda->wal = nullptr;
+    tienda->lsn = 0;
+
+    iniciarIndicesTienda(tienda);
+}
+
+//delete
+void liberarTienda(Tienda* tienda) {
+    // Liberar memoria dinmica (lo que siga en el snapshot se desmapea aparte)
+    // (tambin reinicia los contadores)
+    liberarTabla(tienda, &tienda->productos);
+    liberarTabla(tienda, &tienda->proveedores);
+    liberarTabla(tienda, &tienda->clientes);
+    liberarTabla(tienda, &tienda->transacciones);
+    cerrarVistaSnapshot(tienda);
+    liberarIndicesTienda(tienda);
+}
+
+//======================
+//registro de cambios (WAL)
+//======================
+
+// Cada cambio de los arrays se anota como un registro binario al final de
+// ARCHIVO_WAL. Un hilo escritor vuelca los registros pendientes en lotes con
+// un solo fsync (group commit): mientras un fsync est en curso los cambios
+// nuevos se acumulan y salen todos juntos en el siguiente.
+
+const char ARCHIVO_WAL[] = "tienda.wal";
+
+enum TipoCambio {
+    CAMBIO_ALTA_PRODUCTO = 1,   // payload: Producto
+    CAMBIO_MODIFICA_PRODUCTO,   // payload: Producto
+    CAMBIO_STOCK_PRODUCTO,      // payload: CambioStock
+    CAMBIO_BAJA_PRODUCTO,       // payload: int id
+    CAMBIO_ALTA_PROVEEDOR,      // payload: Proveedor
+    CAMBIO_MODIFICA_PROVEEDOR,  // payload: Proveedor
+    CAMBIO_BAJA_PROVEEDOR,      // payload: int id
+    CAMBIO_ALTA_CLIENTE,        // payload: Cliente
+    CAMBIO_MODIFICA_CLIENTE,    // payload: Cliente
+    CAMBIO_BAJA_CLIENTE,        // payload: int id
+    CAMBIO_TRANSACCIONES        // payload: Transaccion[] de un lote de tickets
+};
+
+struct CabeceraCambio {
+    unsigned int longitud;     // bytes de payload tras la cabecera
+    unsigned int crc;          // CRC32 de lsn, tipo y payload
+    long long lsn;             // nmero de secuencia del cambio
+    int tipo;                  // TipoCambio
+    int reservado;
+};
+
+struct CambioStock {
+    int id;
+    int stock;
+};
+
+// Tope del payload de un registro. Un lote de tickets va entero en uno solo
+// (ver asentarTransacciones), as que este tope limita las lneas por lote.
+const unsigned int MAX_PAYLOAD_CAMBIO = 64 * 1024 * 1024;
+
+struct RegistroCambios {
+    char ruta[260];
+    FILE* archivo;
+
+    mutex mtx;
+    condition_variable hayPendientes;  // despierta al hilo escritor
+    condition_variable hayDurables;    // despierta a quien espera un fsync
+
+    // Registros anotados y an no escritos. El hilo escritor intercambia
+    // este buffer con 'lote' y escribe sin tener tomado el mutex.
+    char* pendientes;
+    long long usado;
+    long long capacidad;
+    char* lote;
+    long long capacidadLote;
+
+    long long lsnAnotado;      // ltimo lsn metido en 'pendientes'
+    long long lsnDurable;      // ltimo lsn que ya pas por fsync
+    bool escribiendo;
+    bool error;
+    bool terminar;
+
+    thread escritor;
+};
+
+unsigned int calcularCrc32(const void* datos, size_t len, unsigned int crc = 0) {
+    static unsigned int tabla[256];
+    static bool lista = false;
+    if (!lista) {
+        for (unsigned int i = 0; i < 256; i++) {
+            unsigned int c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            tabla[i] = c;
+        }
+        lista = true;
+    }
+
+    const unsigned char* p = (const unsigned char*)datos;
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++)
+        crc = tabla[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+unsigned int crcCambio(const CabeceraCambio& cab, const void* payload) {
+    unsigned int crc = calcularCrc32(&cab.lsn, sizeof(cab.lsn));
+    crc = calcularCrc32(&cab.tipo, sizeof(cab.tipo), crc);
+    return calcularCrc32(payload, cab.longitud, crc);
+}
+
+bool truncarArchivo(const char* ruta, long long tam) {
+#ifdef _WIN32
+    HANDLE archivo = CreateFileA(ruta, GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (archivo == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER pos;
+    pos.QuadPart = tam;
+    bool ok = SetFilePointerEx(archivo, pos, nullptr, FILE_BEGIN) && SetEndOfFile(archivo);
+    CloseHandle(archivo);
+    return ok;
+#else
+    return truncate(ruta, tam) == 0;
+#endif
+}
+
+void hiloEscrituraCambios(RegistroCambios* wal) {
+    unique_lock<mutex> lock(wal->mtx);
+
+    while (true) {
+        while (wal->usado == 0 && !wal->terminar)
+            wal->hayPendientes.wait(lock);
+
+        if (wal->usado == 0 && wal->terminar)
+            break;
+
+        // Tomar todo lo pendiente como un lote
+        swap(wal->pendientes, wal->lote);
+        swap(wal->capacidad, wal->capacidadLote);
+        long long bytes = wal->usado;
+        long long lsnLote = wal->lsnAnotado;
+        wal->usado = 0;
+        wal->escribiendo = true;
+        lock.unlock();
+
+        bool ok = fwrite(wal->lote, 1, (size_t)bytes, wal->archivo) == (size_t)bytes &&
+                  sincronizarArchivo(wal->archivo);
+
+        lock.lock();
+        wal->escribiendo = false;
+        if (ok)
+            wal->lsnDurable = lsnLote;
+        else
+            wal->error = true;
+        wal->hayDurables.notify_all();
+    }
+}
+
+RegistroCambios* abrirRegistroCambios(const char* ruta, long long ultimoLsn) {
+    FILE* f = fopen(ruta, "ab");
+    if (f == nullptr) {
+        cout << "ERROR: No se pudo abrir el registro de cambios " << ruta << ".\n";
+        return nullptr;
+    }
+
+    RegistroCambios* wal = new RegistroCambios;
+    snprintf(wal->ruta, sizeof(wal->ruta), "%s", ruta);
+    wal->archivo = f;
+
+    wal->capacidad = 64 * 1024;
+    wal->pendientes = new char[wal->capacidad];
+    wal->usado = 0;
+    wal->capacidadLote = 64 * 1024;
+    wal->lote = new char[wal->capacidadLote];
+
+    wal->lsnAnotado = ultimoLsn;
+    wal->lsnDurable = ultimoLsn;
+    wal->escribiendo = false;
+    wal->error = false;
+    wal->terminar = false;
+
+    wal->escritor = thread(hiloEscrituraCambios, wal);
+    return wal;
+}
+
+// Deja el registro en el buffer de pendientes; no espera al disco
+void walAnotar(RegistroCambios* wal, long long lsn, int tipo, const void* datos, int len) {
+    CabeceraCambio cab;
+    cab.longitud = len;
+    cab.lsn = lsn;
+    cab.tipo = tipo;
+    cab.reservado = 0;
+    cab.crc = crcCambio(cab, datos);
+
+    long long bytes = sizeof(cab) + len;
+
+    lock_guard<mutex> lock(wal->mtx);
+
+    if (wal->usado + bytes > wal->capacidad) {
+        long long nuevaCap = wal->capacidad * 2;
+        while (nuevaCap < wal->usado + bytes) nuevaCap *= 2;
+
+        char* nuevo = new char[nuevaCap];
+        memcpy(nuevo, wal->pendientes, (size_t)wal->usado);
+        delete[] wal->pendientes;
+        wal->pendientes = nuevo;
+        wal->capacidad = nuevaCap;
+    }
+
+    memcpy(wal->pendientes + wal->usado, &cab, sizeof(cab));
+    memcpy(wal->pendientes + wal->usado + sizeof(cab), datos, len);
+
+    // Si el escritor est ocupado ya ver los nuevos registros al terminar
+    bool avisar = wal->usado == 0 && !wal->escribiendo;
+    wal->usado += bytes;
+    wal->lsnAnotado = lsn;
+
+    if (avisar)
+        wal->hayPendientes.notify_one();
+}
+
+// Bloquea hasta que el cambio 'lsn' (y todos los anteriores) estn en disco
+bool walEsperar(RegistroCambios* wal, long long lsn) {
+    unique_lock<mutex> lock(wal->mtx);
+    while (wal->lsnDurable < lsn && !wal->error)
+        wal->hayDurables.wait(lock);
+    return wal->lsnDurable >= lsn;
+}
+
+// Vaca el registro despus de un snapshot: todo lo anotado ya est en l
+void walTruncar(RegistroCambios* wal) {
+    unique_lock<mutex> lock(wal->mtx);
+    while (wal->usado > 0 || wal->escribiendo) {
+        wal->hayPendientes.notify_one();
+        wal->hayDurables.wait(lock);
+    }
+
+    fclose(wal->archivo);
+    wal->archivo = fopen(wal->ruta, "wb");
+    if (wal->archivo == nullptr) {
+        wal->archivo = fopen(wal->ruta, "ab");
+        wal->error = wal->archivo == nullptr;
+    }
+}
+
+void cerrarRegistroCambios(RegistroCambios* wal) {
+    {
+        lock_guard<mutex> lock(wal->mtx);
+        wal->terminar = true;
+        wal->hayPendientes.notify_one();
+    }
+    wal->escritor.join();
+
+    if (wal->archivo != nullptr)
+        fclose(wal->archivo);
+    delete[] wal->pendientes;
+    delete[] wal->lote;
+    delete wal;
+}
+
+void anotarCambio(Tienda* tienda, int tipo, const void* datos, int len) {
+    if (tienda->wal == nullptr) return;
+    walAnotar(tienda->wal, ++tienda->lsn, tipo, datos, len);
+}
+
+// Espera a que los cambios anotados hasta ahora sean durables
+bool confirmarCambios(Tienda* tienda) {
+    if (tienda->wal == nullptr) return true;
+
+    if (!walEsperar(tienda->wal, tienda->lsn)) {
+        cout << "ERROR: No se pudo asegurar el cambio en disco.\n";
+        return false;
+    }
+    return true;
+}
+
+//======================
+//operaciones bsicas sobre los arrays
+//======================
+
+// nicos puntos que modifican los arrays: los usan el men y la recuperacin
+// del registro de cambios, y cada uno anota su cambio en el WAL.
+
+void agregarProducto(Tienda* tienda, const Producto& p) {
+    int index = agregarEnTabla(&tienda->productos, p);
+    if (p.id >= tienda->siguienteIdProducto)
+        tienda->siguienteIdProducto = p.id + 1;
+
+    if (tienda->indiceCodigos.construido)
+        insertarEnIndiceClave(&tienda->indiceCodigos, p.codigo, p.id);
+    trigramasAlta(&tienda->trigramasNombreProducto, p.nombre, p.id);
+    trigramasAlta(&tienda->trigramasCodigoProducto, p.codigo, p.id);
+    if (tienda->productosPorProveedor.construido)
+        agregarIdALista(listaDeProveedor(&tienda->productosPorProveedor, p.idProveedor), p.id);
+    if (tienda->columnasProductos.construido) {
+        reservarColumnasProductos(&tienda->columnasProductos, index, index + 1);
+        escribirEnColumnas(&tienda->columnasProductos, index, p);
+    }
+    if (tienda->fechasProductos.construido)
+        insertarEnIndiceFechas(&tienda->fechasProductos, p.fechaRegistro, p.id);
+    if (tienda->agregados.construido)
+        acumularProducto(&tienda->agregados, p, 1);
+    if (tienda->reposicion.construido)
+        reposicionProducto(&tienda->reposicion, p);
+    ponerProductoEnOrden(tienda, p, TODOS_LOS_ORDENES);
+
+    anotarCambio(tienda, CAMBIO_ALTA_PRODUCTO, &p, sizeof(p));
+}
+
+void reemplazarProducto(Tienda* tienda, int index, const Producto& p) {
+    Producto& anterior = tienda->productos[index];
+    int ordenes = quitarProductoDeOrden(tienda, anterior, ordenesQueCambian(anterior, p));
+    if (tienda->indiceCodigos.construido && strcmp(anterior.codigo, p.codigo) != 0) {
+        quitarDeIndiceClave(&tienda->indiceCodigos, anterior.codigo);
+        insertarEnIndiceClave(&tienda->indiceCodigos, p.codigo, p.id);
+    }
+    trigramasCambio(&tienda->trigramasNombreProducto, anterior.nombre, p.nombre, p.id);
+    trigramasCambio(&tienda->trigramasCodigoProducto, anterior.codigo, p.codigo, p.id);
+    if (tienda->productosPorProveedor.construido && anterior.idProveedor != p.idProveedor) {
+        quitarIdDeLista(listaDeProveedor(&tienda->productosPorProveedor, anterior.idProveedor), p.id);
+        agregarIdALista(listaDeProveedor(&tienda->productosPorProveedor, p.idProveedor), p.id);
+    }
+    if (tienda->columnasProductos.construido)
+        escribirEnColumnas(&tienda->columnasProductos, index, p);
+    if (tienda->fechasProductos.construido && anterior.fechaRegistro != p.fechaRegistro) {
+        quitarDeIndiceFechas(&tienda->fechasProductos, anterior.fechaRegistro, p.id);
+        insertarEnIndiceFechas(&tienda->fechasProductos, p.fechaRegistro, p.id);
+    }
+    if (tienda->agregados.construido) {
+        acumularProducto(&tienda->agregados, anterior, -1);
+        acumularProducto(&tienda->agregados, p, 1);
+    }
+    if (tienda->reposicion.construido)
+        reposicionProducto(&tienda->reposicion, p);
+
+    anterior = p;
+    ponerProductoEnOrden(tienda, p, ordenes);
+    anotarCambio(tienda, CAMBIO_MODIFICA_PRODUCTO, &p, sizeof(p));
+}
+
+void fijarStockProducto(Tienda* tienda, int index, int stock) {
+    int ordenes = quitarProductoDeOrden(tienda, tienda->productos[index], 1 << ORDEN_STOCK);
+    if (tienda->agregados.construido)
+        acumularProducto(&tienda->agregados, tienda->productos[index], -1);
+    tienda->productos[index].stock = stock;
+    if (tienda->agregados.construido)
+        acumularProducto(&tienda->agregados, tienda->productos[index], 1);
+    if (tienda->columnasProductos.construido)
+        tienda->columnasProductos.stocks[index] = stock;
+    if (tienda->reposicion.construido)
+        reposicionProducto(&tienda->reposicion, tienda->productos[index]);
+    ponerProductoEnOrden(tienda, tienda->productos[index], ordenes);
+
+    CambioStock cambio;
+    cambio.id = tienda->productos[index].id;
+    cambio.stock = stock;
+    anotarCambio(tienda, CAMBIO_STOCK_PRODUCTO, &cambio, sizeof(cambio));
+}
+
+void quitarProducto(Tienda* tienda, int index) {
+    Producto& p = tienda->productos[index];
+    int id = p.id;
+    if (tienda->indiceCodigos.construido)
+        quitarDeIndiceClave(&tienda->indiceCodigos, p.codigo);
+    trigramasBaja(&tienda->trigramasNombreProducto);
+    trigramasBaja(&tienda->trigramasCodigoProducto);
+    if (tienda->productosPorProveedor.construido)
+        quitarIdDeLista(listaDeProveedor(&tienda->productosPorProveedor, p.idProveedor), id);
+    if (tienda->fechasProductos.construido)
+        quitarDeIndiceFechas(&tienda->fechasProductos, p.fechaRegistro, id);
+    if (tienda->agregados.construido)
+        acumularProducto(&tienda->agregados, p, -1);
+    if (tienda->reposicion.construido)
+        quitarDeReposicion(&tienda->reposicion, id);
+    quitarProductoDeOrden(tienda, p, TODOS_LOS_ORDENES);
+
+    eliminarDeTabla(&tienda->productos, index);
+    if (tienda->columnasProductos.construido)
+        tienda->columnasProductos.ids[index] = -id;
+
+    anotarCambio(tienda, CAMBIO_BAJA_PRODUCTO, &id, sizeof(id));
+}
+
+void agregarProveedor(Tienda* tienda, const Proveedor& p) {
+    agregarEnTabla(&tienda->proveedores, p);
+    if (p.id >= tienda->siguienteIdProveedor)
+        tienda->siguienteIdProveedor = p.id + 1;
+
+    if (tienda->indiceRifs.construido)
+        insertarEnIndiceClave(&tienda->indiceRifs, p.rif, p.id);
+    trigramasAlta(&tienda->trigramasNombreProveedor, p.nombre, p.id);
+    if (tienda->ordenProveedores.construido)
+        insertarEnOrden(&tienda->ordenProveedores, &tienda->proveedores, claveNombre(p));
+
+    anotarCambio(tienda, CAMBIO_ALTA_PROVEEDOR, &p, sizeof(p));
+}
+
+void reemplazarProveedor(Tienda* tienda, int index, const Proveedor& p) {
+    Proveedor& anterior = tienda->proveedores[index];
+    if (tienda->indiceRifs.construido && strcmp(anterior.rif, p.rif) != 0) {
+        quitarDeIndiceClave(&tienda->indiceRifs, anterior.rif);
+        insertarEnIndiceClave(&tienda->indiceRifs, p.rif, p.id);
+    }
+    trigramasCambio(&tienda->trigramasNombreProveedor, anterior.nombre, p.nombre, p.id);
+    bool reordenar = tienda->ordenProveedores.construido && strcmp(anterior.nombre, p.nombre) != 0;
+    if (reordenar)
+        quitarDeOrden(&tienda->ordenProveedores, &tienda->proveedores, claveNombre(anterior));
+
+    anterior = p;
+    if (reordenar)
+        insertarEnOrden(&tienda->ordenProveedores, &tienda->proveedores, claveNombre(p));
+    anotarCambio(tienda, CAMBIO_MODIFICA_PROVEEDOR, &p, sizeof(p));
+}
+
+void quitarProveedor(Tienda* tienda, int index) {
+    Proveedor& p = tienda->proveedores[index];
+    int id = p.id;
+    if (tienda->indiceRifs.construido)
+        quitarDeIndiceClave(&tienda->indiceRifs, p.rif);
+    trigramasBaja(&tienda->trigramasNombreProveedor);
+    if (tienda->ordenProveedores.construido)
+        quitarDeOrden(&tienda->ordenProveedores, &tienda->proveedores, claveNombre(p));
+
+    eliminarDeTabla(&tienda->proveedores, index);
+
+    anotarCambio(tienda, CAMBIO_BAJA_PROVEEDOR, &id, sizeof(id));
+}
+
+void agregarCliente(Tienda* tienda, const Cliente& c) {
+    agregarEnTabla(&tienda->clientes, c);
+    if (c.id >= tienda->siguienteIdCliente)
+        tienda->siguienteIdCliente = c.id + 1;
+
+    if (tienda->indiceCedulas.construido)
+        insertarEnIndiceClave(&tienda->indiceCedulas, c.cedula, c.id);
+    trigramasAlta(&tienda->trigramasNombreCliente, c.nombre, c.id);
+    if (tienda->ordenClientes.construido)
+        insertarEnOrden(&tienda->ordenClientes, &tienda->clientes, claveNombre(c));
+
+    anotarCambio(tienda, CAMBIO_ALTA_CLIENTE, &c, sizeof(c));
+}
+
+void reemplazarCliente(Tienda* tienda, int index, const Cliente& c) {
+    Cliente& anterior = tienda->clientes[index];
+    if (tienda->indiceCedulas.construido && strcmp(anterior.cedula, c.cedula) != 0) {
+        quitarDeIndiceClave(&tienda->indiceCedulas, anterior.cedula);
+        insertarEnIndiceClave(&tienda->indiceCedulas, c.cedula, c.id);
+    }
+    trigramasCambio(&tienda->trigramasNombreCliente, anterior.nombre, c.nombre, c.id);
+    bool reordenar = tienda->ordenClientes.construido && strcmp(anterior.nombre, c.nombre) != 0;
+    if (reordenar)
+        quitarDeOrden(&tienda->ordenClientes, &tienda->clientes, claveNombre(anterior));
+
+    anterior = c;
+    if (reordenar)
+        insertarEnOrden(&tienda->ordenClientes, &tienda->clientes, claveNombre(c));
+    anotarCambio(tienda, CAMBIO_MODIFICA_CLIENTE, &c, sizeof(c));
+}
+
+void quitarCliente(Tienda* tienda, int index) {
+    Cliente& c = tienda->clientes[index];
+    int id = c.id;
+    if (tienda->indiceCedulas.construido)
+        quitarDeIndiceClave(&tienda->indiceCedulas, c.cedula);
+    trigramasBaja(&tienda->trigramasNombreCliente);
+    if (tienda->ordenClientes.construido)
+        quitarDeOrden(&tienda->ordenClientes, &tienda->clientes, claveNombre(c));
+
+    eliminarDeTabla(&tienda->clientes, index);
+
+    anotarCambio(tienda, CAMBIO_BAJA_CLIENTE, &id, sizeof(id));
+}
+
+void compactarProductos(Tienda* tienda) {
+    // Las columnas calientes siguen las posiciones de la tabla
+    if (compactarTabla(&tienda->productos) && tienda->columnasProductos.construido)
+        construirColumnasProductos(tienda);
+}
+
+void compactarTablas(Tienda* tienda) {
+    compactarProductos(tienda);
+    compactarTabla(&tienda->proveedores);
+    compactarTabla(&tienda->clientes);
+}
+
+// Compacta solo las tablas en las que las lpidas pasan del umbral
+void compactarSiHaceFalta(Tienda* tienda) {
+    if (necesitaCompactar(tienda->productos))
+        compactarProductos(tienda);
+    if (necesitaCompactar(tienda->proveedores))
+        compactarTabla(&tienda->proveedores);
+    if (necesitaCompactar(tienda->clientes))
+        compactarTabla(&tienda->clientes);
+}
+
+// Asienta transacciones ya validadas: las agrega al historial y mueve el stock
+// de cada producto. Todo el lote va en un nico registro del WAL, as que tras
+// una cada se recupera completo o no se recupera.
+void asentarTransacciones(Tienda* tienda, const Transaccion* lineas, int num) {
+    if (num <= 0) return;
+
+    reservarTabla(&tienda->transacciones, tienda->transacciones.num + num);
+
+    for (int i = 0; i < num; i++) {
+        const Transaccion& t = lineas[i];
+        agregarEnTabla(&tienda->transacciones, t);
+        if (t.id >= tienda->siguienteIdTransaccion)
+            tienda->siguienteIdTransaccion = t.id + 1;
+        if (tienda->fechasTransacciones.construido)
+            insertarEnIndiceFechas(&tienda->fechasTransacciones, t.fecha, t.id);
+        if (tienda->columnasTransacciones.construido)
+            agregarEnColumnas(&tienda->columnasTransacciones, t);
+
+        int index = buscarProductoPorID(tienda, t.idProducto);
+        if (index == -1) continue;
+        if (tienda->agregados.construido)
+            acumularProducto(&tienda->agregados, tienda->productos[index], -1);
+        int ordenes = quitarProductoDeOrden(tienda, tienda->productos[index], 1 << ORDEN_STOCK);
+        if (strcmp(t.tipo, "COMPRA") == 0)
+            tienda->productos[index].stock += t.cantidad;
+        else
+            tienda->productos[index].stock -= t.cantidad;
+        if (tienda->agregados.construido)
+            acumularProducto(&tienda->agregados, tienda->productos[index], 1);
+        if (tienda->columnasProductos.construido)
+            tienda->columnasProductos.stocks[index] = tienda->productos[index].stock;
+        if (tienda->reposicion.construido)
+            reposicionProducto(&tienda->reposicion, tienda->productos[index]);
+        ponerProductoEnOrden(tienda, tienda->productos[index], ordenes);
+    }
+
+    anotarCambio(tienda, CAMBIO_TRANSACCIONES, lineas, num * (int)sizeof(Transaccion));
+}
+
+//======================
+//acceso concurrente
+//======================
+
+// Varios hilos (una caja cada uno) pueden compartir una Tienda: las consultas
+// corren en paralelo y los cambios, de a uno. Hay un solo cerrojo para toda
+// la tienda porque casi cualquier cambio toca varias tablas e ndices a la
+// vez (una venta mueve stock, historial, columnas y totales).
+//
+// Las consultas arman sus ndices la primera vez que los usan. Aqu se arman
+// antes, con el cerrojo exclusivo, y cada cambio los deja al da al salir;
+// as, con el cerrojo compartido nadie escribe y los arrays que crecen o se
+// rearman nunca se cambian debajo de un lector.
+
+// Los escritores tienen prioridad: con uno esperando no entran lectores
+// nuevos, para que los cambios de stock no queden detrs de las bsquedas
+struct CerrojoLectorEscritor {
+    mutex m;
+    condition_variable libre;
+    int lectores;
+    int escritoresEsperando;
+    bool escribiendo;
+};
+
+struct TiendaCompartida {
+    Tienda* tienda;
+    CerrojoLectorEscritor cerrojo;
+};
+
+void iniciarCerrojo(CerrojoLectorEscritor* c) {
+    c->lectores = 0;
+    c->escritoresEsperando = 0;
+    c->escribiendo = false;
+}
+
+void entrarLectura(CerrojoLectorEscritor* c) {
+    unique_lock<mutex> lock(c->m);
+    c->libre.wait(lock, [c] { return !c->escribiendo && c->escritoresEsperando == 0; });
+    c->lectores++;
+}
+
+void salirLectura(CerrojoLectorEscritor* c) {
+    lock_guard<mutex> lock(c->m);
+    if (--c->lectores == 0)
+        c->libre.notify_all();
+}
+
+void entrarEscritura(CerrojoLectorEscritor* c) {
+    unique_lock<mutex> lock(c->m);
+    c->escritoresEsperando++;
+    c->libre.wait(lock, [c] { return !c->escribiendo && c->lectores == 0; });
+    c->escritoresEsperando--;
+    c->escribiendo = true;
+}
+
+void salirEscritura(CerrojoLectorEscritor* c) {
+    lock_guard<mutex> lock(c->m);
+    c->escribiendo = false;
+    c->libre.notify_all();
+}
+
+// Arma todo lo que las consultas construyen de forma perezosa
+void prepararLecturas(Tienda* tienda) {
+    if (!tienda->productos.indice.construido) construirIndiceTabla(&tienda->productos);
+    if (!tienda->proveedores.indice.construido) construirIndiceTabla(&tienda->proveedores);
+    if (!tienda->clientes.indice.construido) construirIndiceTabla(&tienda->clientes);
+    if (!tienda->transacciones.indice.construido) construirIndiceTabla(&tienda->transacciones);
+
+    if (!tienda->indiceCodigos.construido) construirIndiceCodigos(tienda);
+    if (!tienda->indiceRifs.construido) construirIndiceRifs(tienda);
+    if (!tienda->indiceCedulas.construido) construirIndiceCedulas(tienda);
+
+    refrescarTrigramas(tienda, &tienda->trigramasNombreProducto, construirTrigramasNombreProducto,
+                       tienda->productos.num);
+    refrescarTrigramas(tienda, &tienda->trigramasCodigoProducto, construirTrigramasCodigoProducto,
+                       tienda->productos.num);
+    refrescarTrigramas(tienda, &tienda->trigramasNombreProveedor, construirTrigramasNombreProveedor,
+                       tienda->proveedores.num);
+    refrescarTrigramas(tienda, &tienda->trigramasNombreCliente, construirTrigramasNombreCliente,
+                       tienda->clientes.num);
+
+    if (!tienda->productosPorProveedor.construido) construirIndiceProveedorProductos(tienda);
+    columnasDeProductos(tienda);
+    fechasDeProductos(tienda);
+    fechasDeTransacciones(tienda);
+    agregadosDeInventario(tienda);
+    reposicionDeProductos(tienda);
+    for (int campo = ORDEN_NOMBRE; campo <= ORDEN_FECHA; campo++)
+        ordenProductos(tienda, campo);
+    ordenProveedores(tienda);
+    ordenClientes(tienda);
+    columnasDeTransacciones(tienda);
+}
+
+// La tienda no se debe usar directamente mientras est compartida
+void compartirTienda(TiendaCompartida* compartida, Tienda* tienda) {
+    compartida->tienda = tienda;
+    iniciarCerrojo(&compartida->cerrojo);
+    prepararLecturas(tienda);
+}
+
+// f(tienda) con el cerrojo compartido: solo consultas (buscar*, listar,
+// tabla*, reportes). El cerrojo no es reentrante.
+template <typename F>
+void leerTienda(TiendaCompartida* compartida, F f) {
+    entrarLectura(&compartida->cerrojo);
+    f(compartida->tienda);
+    salirLectura(&compartida->cerrojo);
+}
+
+// f(tienda) con el cerrojo exclusivo; al terminar deja los ndices listos
+// para los lectores
+template <typename F>
+void modificarTienda(TiendaCompartida* compartida, F f) {
+    entrarEscritura(&compartida->cerrojo);
+    f(compartida->tienda);
+    prepararLecturas(compartida->tienda);
+    salirEscritura(&compartida->cerrojo);
+}
+
+//======================
+//2.2.1
+//======================
+
+void crearProducto(Tienda* tienda) {
+    if (!confirmar("Desea registrar un nuevo producto? (S/N): "))
+        return;
+
+    Producto nuevo;
+
+    // --- Cdigo ---
+   solicitarString(
+    "Ingrese cdigo del producto (o CANCELAR): ",
+    nuevo.codigo,
+    20,
+    sinEspacios,
+    "ERROR: El cdigo no puede contener espacios.\n"
+);
+
+if (strcmp(nuevo.codigo, "CANCELAR") == 0 || strcmp(nuevo.codigo, "0") == 0)
+    return;
+
+if (codigoProductoDuplicado(tienda, nuevo.codigo)) {
+    cout << "ERROR: El cdigo '" << nuevo.codigo << "' ya est registrado.\n";
+    return;
+}
+
+    // --- Nombre ---
+    solicitarString("Ingrese nombre del producto (o CANCELAR): ", nuevo.nombre, 100);
+    if (strcmp(nuevo.nombre, "CANCELAR") == 0 || strcmp(nuevo.nombre, "0") == 0)
+        return;
+
+    // --- Descripcin ---
+    solicitarString("Ingrese descripcin (o CANCELAR): ", nuevo.descripcion, 200);
+    if (strcmp(nuevo.descripcion, "CANCELAR") == 0 || strcmp(nuevo.descripcion, "0") == 0)
+        return;
+
+    // --- ID Proveedor ---
+    cout << "Ingrese ID del proveedor (o 0 para cancelar): ";
+    cin >> nuevo.idProveedor;
+
+    if (nuevo.idProveedor == 0)
+        return;
+
+    if (!existeProveedor(tienda, nuevo.idProveedor)) {
+        cout << "ERROR: El proveedor con ID " << nuevo.idProveedor << " no existe.\n";
+        return;
+    }
+
+    // --- Precio ---
+    nuevo.precio = solicitarEnteroPositivo("Ingrese precio (>0): ");
+
+    // --- Stock ---
+    nuevo.stock = solicitarEnteroNoNegativo("Ingrese stock (>=0): ");
+
+    // --- Stock mnimo ---
+    nuevo.stockMinimo = solicitarEnteroNoNegativo("Ingrese stock mnimo (0 = sin aviso): ");
+
+    // Fecha automtica
+    nuevo.fechaRegistro = fechaActual();
+
+    // --- Resumen ---
+    cout << "\n=== RESUMEN DEL PRODUCTO ===\n";
+    mostrarProducto(nuevo);
+
+    if (!confirmar("Guardar producto? (S/N): "))
+        return;
+
+    // Guardado final
+    nuevo.id = tienda->siguienteIdProducto++;
+    agregarProducto(tienda, nuevo);
+
+    if (confirmarCambios(tienda))
+        cout << "\nProducto registrado exitosamente.\n";
+}
+
+//========================
+//2.2.2
+//========================
+
+void buscarProducto(Tienda* tienda) {
+    int opcion;
+    cout << "\n=== BUSCAR PRODUCTO ===\n";
+    cout << "1. Buscar por ID\n";
+    cout << "2. Buscar por nombre (parcial)\n";
+    cout << "3. Buscar por cdigo (parcial)\n";
+    cout << "4. Listar por proveedor\n";
+    cout << "5. Buscar por rango de precio\n";
+    cout << "6. Listar con stock bajo\n";
+    cout << "7. Buscar por fecha de registro\n";
+    cout << "0. Cancelar\n";
+    cout << "Seleccione una opcin: ";
+    cin >> opcion;
+
+    if (opcion == 0) return;
+
+    char buffer[200];
+
+    switch (opcion) {
+
+    // 1. Buscar por ID
+    case 1: {
+        int id;
+        cout << "Ingrese ID del producto: ";
+        cin >> id;
+
+        int index = buscarProductoPorID(tienda, id);
+        if (index == -1) {
+            cout << "ERROR: No se encontr un producto con ID " << id << ".\n";
+            return;
+        }
+
+        cout << "\n=== PRODUCTO ENCONTRADO ===\n";
+        mostrarProducto(tienda->productos[index]);
+        return;
+    }
+
+    // 2. Buscar por nombre (parcial)
+    case 2: {
+    solicitarString("Ingrese parte del nombre: ", buffer, 200);
+
+    int numResultados = 0;
+    int* indices = buscarProductosPorNombre(tienda, buffer, &numResultados);
+
+    if (numResultados == 0) {
+        cout << "No se encontraron coincidencias.\n";
+        return;
+    }
+
+    cout << "\n=== RESULTADOS ===\n";
+    for (int i = 0; i < numResultados; i++) {
+        int idx = indices[i];
+        mostrarProducto(tienda->productos[idx]);
+        cout << "-----------------------------\n";
+    }
+
+    delete[] indices; // obligatorio
+    return;
+	}
+
+
+    // 3. Buscar por cdigo (parcial)
+    case 3: {
+        solicitarString("Ingrese parte del cdigo: ", buffer, 200);
+        PatronTexto filtro;
+        prepararPatron(&filtro, buffer);
+
+        bool encontrado = false;
+        cout << "\n=== RESULTADOS ===\n";
+
+        int numCandidatos;
+        int* candidatos = candidatosEnTienda(tienda, &tienda->trigramasCodigoProducto,
+                                             construirTrigramasCodigoProducto,
+                                             tienda->productos.num, buffer, &numCandidatos);
+        if (numCandidatos >= 0) {
+            for (int i = 0; i < numCandidatos; i++) {
+                int index = buscarProductoPorID(tienda, candidatos[i]);
+                if (index != -1 && contieneTexto(tienda->productos[index].codigo,
+                                                 sizeof(Producto::codigo), &filtro)) {
+                    mostrarProducto(tienda->productos[index]);
+                    cout << "-----------------------------\n";
+                    encontrado = true;
+                }
+            }
+            delete[] candidatos;
+        } else {
+            int numResultados;
+            int* indices = filtrarPorTexto(tienda->productos, &Producto::codigo, &filtro, &numResultados);
+            for (int i = 0; i < numResultados; i++) {
+                mostrarProducto(tienda->productos[indices[i]]);
+                cout << "-----------------------------\n";
+            }
+            encontrado = numResultados > 0;
+            delete[] indices;
+        }
+
+        if (!encontrado)
+            cout << "No se encontraron coincidencias.\n";
+
+        return;
+    }
+
+    // 4. Listar por proveedor
+    case 4: {
+        int idProv;
+        cout << "Ingrese ID del proveedor: ";
+        cin >> idProv;
+
+        if (!existeProveedor(tienda, idProv)) {
+            cout << "ERROR: El proveedor con ID " << idProv << " no existe.\n";
+            return;
+        }
+
+        bool encontrado = false;
+        cout << "\n=== PRODUCTOS DEL PROVEEDOR " 
+             << obtenerNombreProveedor(tienda, idProv) << " ===\n";
+
+        const ListaIds* lista = productosDeProveedor(tienda, idProv);
+        for (int i = 0; lista != nullptr && i < lista->num; i++) {
+            int index = buscarProductoPorID(tienda, lista->ids[i]);
+            if (index != -1) {
+                mostrarProducto(tienda->productos[index]);
+                cout << "-----------------------------\n";
+                encontrado = true;
+            }
+        }
+
+        if (!encontrado)
+            cout << "No hay productos asociados a ese proveedor.\n";
+
+        return;
+    }
+
+    // 5. Rango de precio
+    case 5: {
+        float minimo, maximo;
+        cout << "Precio mnimo: ";
+        cin >> minimo;
+        cout << "Precio mximo: ";
+        cin >> maximo;
+
+        int numResultados;
+        int* resultados = productosEnRangoDePrecio(tienda, minimo, maximo, &numResultados);
+
+        if (numResultados == 0) {
+            cout << "No se encontraron productos en ese rango.\n";
+            return;
+        }
+
+        for (int i = 0; i < numResultados; i++) {
+            mostrarProducto(tienda->productos[resultados[i]]);
+            cout << "-----------------------------\n";
+        }
+
+        delete[] resultados;
+        return;
+    }
+
+    // 6. Stock bajo
+    case 6: {
+        int umbral = solicitarEnteroNoNegativo("Mostrar productos con stock menor o igual a: ");
+
+        int numResultados;
+        int* resultados = productosConStockHasta(tienda, umbral, &numResultados);
+
+        if (numResultados == 0) {
+            cout << "No hay productos con stock menor o igual a " << umbral << ".\n";
+            return;
+        }
+
+        for (int i = 0; i < numResultados; i++) {
+            mostrarProducto(tienda->productos[resultados[i]]);
+            cout << "-----------------------------\n";
+        }
+
+        delete[] resultados;
+        return;
+    }
+
+    // 7. Rango de fechas de registro
+    case 7: {
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        int desde = solicitarFecha("Desde (YYYY-MM-DD): ");
+        int hasta = solicitarFecha("Hasta (YYYY-MM-DD): ");
+
+        int numResultados;
+        int* resultados = productosRegistradosEntre(tienda, desde, hasta, &numResultados);
+
+        if (numResultados == 0) {
+            cout << "No hay productos registrados en ese rango.\n";
+            return;
+        }
+
+        for (int i = 0; i < numResultados; i++) {
+            mostrarProducto(tienda->productos[resultados[i]]);
+            cout << "-----------------------------\n";
+        }
+
+        delete[] resultados;
+        return;
+    }
+
+    default:
+        cout << "Opcin invlida.\n";
+        return;
+    }
+}
+
+//========================
+//2.2.3
+//========================
+
+void actualizarProducto(Tienda* tienda) {
+    int id;
+    cout << "Ingrese el ID del producto a actualizar: ";
+    cin >> id;
+
+    int index = buscarProductoPorID(tienda, id);
+    if (index == -1) {
+        cout << "ERROR: No existe un producto con ese ID.\n";
+        return;
+    }
+
+    Producto* original = &tienda->productos[index];
+    Producto temp = *original; // copia temporal
+
+    int opcion;
+
+    do {
+        cout << "\n=== EDITAR PRODUCTO ===\n";
+        cout << "1. Cdigo: " << temp.codigo << endl;
+        cout << "2. Nombre: " << temp.nombre << endl;
+        cout << "3. Descripcin: " << temp.descripcion << endl;
+        cout << "4. Proveedor ID: " << temp.idProveedor << endl;
+        cout << "5. Precio: " << temp.precio << endl;
+        cout << "6. Stock: " << temp.stock << endl;
+        cout << "7. Stock mnimo: " << temp.stockMinimo << endl;
+        cout << "8. Guardar cambios\n";
+        cout << "0. Cancelar sin guardar\n";
+        cout << "Opcin: ";
+        cin >> opcion;
+
+        cin.ignore(); // limpiar buffer
+
+        switch (opcion) {
+
+        case 1: { // Cdigo
+            char nuevoCodigo[20];
+            solicitarString("Nuevo cdigo: ", nuevoCodigo, 20);
+
+            if (codigoProductoDuplicado(tienda, nuevoCodigo, temp.id)) {
+                cout << "ERROR: El cdigo '" << nuevoCodigo << "' ya est registrado.\n";
+            } else {
+                strcpy(temp.codigo, nuevoCodigo);
+            }
+            break;
+        }
+
+        case 2: // Nombre
+            solicitarString("Nuevo nombre: ", temp.nombre, 100);
+            break;
+
+        case 3: // Descripcin
+            solicitarString("Nueva descripcin: ", temp.descripcion, 200);
+            break;
+
+        case 4: { // Proveedor
+            int nuevoProv;
+            cout << "Nuevo ID de proveedor: ";
+            cin >> nuevoProv;
+
+            if (!existeProveedor(tienda, nuevoProv)) {
+                cout << "ERROR: El proveedor con ID " << nuevoProv << " no existe.\n";
+            } else {
+                temp.idProveedor = nuevoProv;
+            }
+            break;
+        }
+
+        case 5: // Precio
+            temp.precio = solicitarEnteroPositivo("Nuevo precio (>0): ");
+            break;
+
+        case 6: // Stock
+            temp.stock = solicitarEnteroNoNegativo("Nuevo stock (>=0): ");
+            break;
+
+        case 7: // Stock mnimo
+            temp.stockMinimo = solicitarEnteroNoNegativo("Nuevo stock mnimo (0 = sin aviso): ");
+            break;
+
+        case 8: // Guardar cambios
+            cout << "\n=== RESUMEN FINAL ===\n";
+            mostrarProducto(temp);
+
+            if (confirmar("Confirmar cambios? (S/N): ")) {
+                reemplazarProducto(tienda, index, temp);
+                if (confirmarCambios(tienda))
+                    cout << "Cambios guardados exitosamente.\n";
+            } else {
+                cout << "Cambios descartados.\n";
+            }
+            return;
+
+        case 0:
+            cout << "Cancelado. No se guardaron cambios.\n";
+            return;
+
+        default:
+            cout << "Opcin invlida.\n";
+        }
+
+    } while (true);
+}
+
+//========================
+//2.2.4
+//========================
+
+void actualizarStockProducto(Tienda* tienda) {
+    int id;
+    cout << "Ingrese el ID del producto: ";
+    cin >> id;
+
+    int index = buscarProductoPorID(tienda, id);
+    if (index == -1) {
+        cout << "ERROR: No existe un producto con ese ID.\n";
+        return;
+    }
+
+    Producto* p = &tienda->productos[index];
+
+    cout << "\n=== ACTUALIZAR STOCK ===\n";
+    cout << "Producto: " << p->nombre << endl;
+    cout << "Stock actual: " << p->stock << endl;
+
+    int ajuste;
+    cout << "Ingrese ajuste (+ para aumentar, - para disminuir): ";
+    cin >> ajuste;
+
+    int nuevoStock = p->stock + ajuste;
+
+    if (nuevoStock < 0) {
+        cout << "ERROR: Stock insuficiente. Disponible: " 
+             << p->stock << ", Solicitado: " << (-ajuste) << endl;
+        return;
+    }
+
+    cout << "Stock final sera: " << nuevoStock << endl;
+
+    if (!confirmar("Confirmar cambio? (S/N): "))
+        return;
+
+    fijarStockProducto(tienda, index, nuevoStock);
+    if (confirmarCambios(tienda))
+        cout << "Stock actualizado exitosamente.\n";
+    if (nuevoStock < p->stockMinimo)
+        cout << "AVISO: El stock qued por debajo del mnimo (" << p->stockMinimo << ").\n";
+}
+
+const ColumnaTabla COLUMNAS_REPOSICION[] = {
+    {"Proveedor", 18}, {"ID", 6}, {"Cdigo", 12}, {"Nombre", 24},
+    {"Stock", 7}, {"Mnimo", 7}, {"Faltan", 7}
+};
+
+// Una fila por producto, en el orden de productosPorReponer
+bool tablaPorReponer(Tienda* tienda, FILE* destino, const int* posiciones, int num) {
+    SalidaTabla s;
+    iniciarSalidaTabla(&s, destino, COLUMNAS_REPOSICION, sizeof(COLUMNAS_REPOSICION) / sizeof(ColumnaTabla));
+    encabezadoTabla(&s, "PRODUCTOS POR REPONER");
+    for (int i = 0; i < num; i++) {
+        const Producto& p = tienda->productos[posiciones[i]];
+        celdaTexto(&s, 0, obtenerNombreProveedor(tienda, p.idProveedor));
+        celdaEntero(&s, 1, p.id);
+        celdaTexto(&s, 2, p.codigo);
+        celdaTexto(&s, 3, p.nombre);
+        celdaEntero(&s, 4, p.stock);
+        celdaEntero(&s, 5, p.stockMinimo);
+        celdaEntero(&s, 6, p.stockMinimo - p.stock);
+    }
+    pieTabla(&s);
+    return terminarSalidaTabla(&s);
+}
+
+void productosParaReponer(Tienda* tienda) {
+    cout << "\n=== PRODUCTOS POR REPONER ===\n";
+    int k = solicitarEnteroNoNegativo("Cuntos mostrar, los ms urgentes (0 = todos): ");
+    int idProveedor = solicitarEnteroNoNegativo("ID del proveedor (0 = todos): ");
+
+    if (idProveedor != 0 && !existeProveedor(tienda, idProveedor)) {
+        cout << "ERROR: El proveedor con ID " << idProveedor << " no existe.\n";
+        return;
+    }
+
+    int num;
+    int* posiciones = productosPorReponer(tienda, k, idProveedor, &num);
+    if (num == 0) {
+        cout << "No hay productos por debajo de su stock mnimo.\n";
+        return;
+    }
+
+    tablaPorReponer(tienda, stdout, posiciones, num);
+    delete[] posiciones;
+}
+
+//========================
+//2.2.5
+//========================
+
+// Listado de productos en el orden de 'campo' (CampoOrden)
+bool tablaProductosEnOrden(Tienda* tienda, FILE* destino, int desde, int limite, int campo, bool descendente) {
+    const IndiceOrden* orden = campo == ORDEN_REGISTRO ? nullptr : ordenProductos(tienda, campo);
+    SalidaTabla s;
+    iniciarSalidaTabla(&s, destino, COLUMNAS_PRODUCTOS, sizeof(COLUMNAS_PRODUCTOS) / sizeof(ColumnaTabla));
+    encabezadoTabla(&s, "LISTADO DE PRODUCTOS");
+    paraCadaEnListado(orden, tienda->productos, descendente, desde, limite, [&](Producto& p, int) {
+        filaProducto(&s, p, obtenerNombreProveedor(tienda, p.idProveedor));
+    });
+    pieTabla(&s);
+    return terminarSalidaTabla(&s);
+}
+
+bool tablaProductos(Tienda* tienda, FILE* destino, int desde, int limite) {
+    return tablaProductosEnOrden(tienda, destino, desde, limite, ORDEN_REGISTRO, false);
+}
+
+void listarProductos(Tienda* tienda) {
+    int activos = activosEnTabla(tienda->productos);
+    if (activos == 0) {
+        cout << "No hay productos registrados.\n";
+        return;
+    }
+
+    int campo;
+    bool descendente;
+    solicitarOrden(true, &campo, &descendente);
+    mostrarPorPaginas(tienda, [&](Tienda* t, FILE* destino, int desde, int limite) {
+        return tablaProductosEnOrden(t, destino, desde, limite, campo, descendente);
+    }, activos, "productos");
+}
+
+
+//========================
+//2.2.6
+//========================
+
+void eliminarProducto(Tienda* tienda) {
+    int id;
+    cout << "Ingrese el ID del producto a eliminar: ";
+    cin >> id;
+
+    int index = buscarProductoPorID(tienda, id);
+    if (index == -1) {
+        cout << "ERROR: No existe un producto con ese ID.\n";
+        return;
+    }
+
+    Producto& p = tienda->productos[index];
+
+    cout << "\n=== PRODUCTO A ELIMINAR ===\n";
+    mostrarProducto(p);
+
+    // Advertencia por transacciones asociadas
+    bool tieneTransacciones = false;
+    for (int i = 0; i < tienda->transacciones.num; i++) {
+        if (tienda->transacciones[i].idProducto == id) {
+            tieneTransacciones = true;
+            break;
+        }
+    }
+
+    if (tieneTransacciones) {
+        cout << "\nADVERTENCIA: Este producto tiene transacciones asociadas.\n";
+    }
+
+    if (!confirmar("\nEliminar producto? (S/N): ")) {
+        cout << "Eliminacin cancelada.\n";
+        return;
+    }
+
+    quitarProducto(tienda, index);
+
+    if (confirmarCambios(tienda))
+        cout << "Producto eliminado exitosamente.\n";
+
+    compactarSiHaceFalta(tienda);
+}
+
+//2.3
+
+void crearProveedor(Tienda* tienda) {
+    if (!confirmar("Desea registrar un nuevo proveedor? (S/N): "))
+        return;
+
+    Proveedor nuevo;
+
+    // --- RIF ---
+    solicitarString(
+        "Ingrese RIF del proveedor (o CANCELAR): ",
+        nuevo.rif,
+        20,
+        nullptr
+    );
+
+    if (strcmp(nuevo.rif, "CANCELAR") == 0 || strcmp(nuevo.rif, "0") == 0)
+        return;
+
+    if (rifDuplicado(tienda, nuevo.rif)) {
+        cout << "ERROR: El RIF '" << nuevo.rif << "' ya est registrado.\n";
+        return;
+    }
+
+    // --- Nombre ---
+    solicitarString("Ingrese nombre del proveedor (o CANCELAR): ",
+                    nuevo.nombre, 100);
+
+    if (strcmp(nuevo.nombre, "CANCELAR") == 0 || strcmp(nuevo.nombre, "0") == 0)
+        return;
+
+    // --- Email ---
+    solicitarString(
+        "Ingrese email del proveedor (o CANCELAR): ",
+        nuevo.email,
+        100,
+        emailValido,
+        "ERROR: El email debe contener '@' y un punto.\n"
+    );
+
+    if (strcmp(nuevo.email, "CANCELAR") == 0 || strcmp(nuevo.email, "0") == 0)
+        return;
+
+    // --- Telfono ---
+    solicitarString("Ingrese telfono del proveedor (o CANCELAR): ",
+                    nuevo.telefono, 20);
+
+    if (strcmp(nuevo.telefono, "CANCELAR") == 0 || strcmp(nuevo.telefono, "0") == 0)
+        return;
+
+    // --- Confirmacin ---
+    cout << "\n=== RESUMEN DEL PROVEEDOR ===\n";
+    cout << "RIF: " << nuevo.rif << endl;
+    cout << "Nombre: " << nuevo.nombre << endl;
+    cout << "Email: " << nuevo.email << endl;
+    cout << "Telfono: " << nuevo.telefono << endl;
+
+    if (!confirmar("Guardar proveedor? (S/N): "))
+        return;
+
+    // --- Guardar ---
+    nuevo.id = tienda->siguienteIdProveedor++;
+    agregarProveedor(tienda, nuevo);
+
+    if (confirmarCambios(tienda))
+        cout << "Proveedor registrado exitosamente.\n";
+}
+
+//2.3.2
+
+void buscarProveedor(Tienda* tienda) {
+    int opcion;
+
+    do {
+        cout << "\n=== BUSCAR PROVEEDOR ===\n";
+        cout << "1. Buscar por ID\n";
+        cout << "2. Buscar por nombre (coincidencia parcial)\n";
+        cout << "3. Buscar por RIF\n";
+        cout << "0. Cancelar\n";
+        cout << "Seleccione una opcin: ";
+        cin >> opcion;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        if (opcion == 0)
+            return;
+
+        int index = -1;
+
+        switch (opcion) {
+
+            case 1: {
+                int id;
+                cout << "Ingrese ID del proveedor: ";
+                cin >> id;
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+                index = buscarProveedorPorID(tienda, id);
+                break;
+            }
+
+            case 2: {
+                char nombre[100];
+                solicitarString("Ingrese nombre o parte del nombre: ", nombre, 100);
+                index = buscarProveedorPorNombre(tienda, nombre);
+                break;
+            }
+
+            case 3: {
+                char rif[20];
+                solicitarString("Ingrese RIF del proveedor: ", rif, 20);
+                index = buscarProveedorPorRIF(tienda, rif);
+                break;
+            }
+
+            default:
+                cout << "Opcin invlida.\n";
+                continue;
+        }
+
+        if (index == -1) {
+            cout << "No se encontr ningn proveedor con ese criterio.\n";
+        } else {
+            mostrarProveedor(tienda->proveedores[index]);
+        }
+
+        system("pause");
+
+    } while (opcion != 0);
+}
+
+//2.3.3
+
+void actualizarProveedor(Tienda* tienda) {
+    int id;
+    cout << "Ingrese el ID del proveedor a actualizar (0 para cancelar): ";
+    cin >> id;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    if (id == 0)
+        return;
+
+    int index = buscarProveedorPorID(tienda, id);
+    if (index == -1) {
+        cout << "ERROR: No existe un proveedor con ese ID.\n";
+        return;
+    }
+
+    Proveedor& original = tienda->proveedores[index];
+    Proveedor temp = original; // copia temporal
+
+    cout << "\n=== PROVEEDOR ENCONTRADO ===\n";
+    mostrarProveedor(original);
+
+    if (!confirmar("\nDesea modificar este proveedor? (S/N): "))
+        return;
+
+    // --- Nombre ---
+    cout << "\nNombre actual: " << temp.nombre << endl;
+    solicitarString("Nuevo nombre (ENTER para mantener): ", temp.nombre, 100);
+    if (strlen(temp.nombre) == 0)
+        strcpy(temp.nombre, original.nombre);
+
+    // --- RIF ---
+    cout << "\nRIF actual: " << temp.rif << endl;
+    solicitarString("Nuevo RIF (ENTER para mantener): ", temp.rif, 20);
+    if (strlen(temp.rif) == 0)
+        strcpy(temp.rif, original.rif);
+    else if (rifDuplicado(tienda, temp.rif, original.id)) {
+        cout << "ERROR: El RIF '" << temp.rif << "' ya est registrado.\n";
+        return;
+    }
+
+    // --- Telfono ---
+    cout << "\nTelfono actual: " << temp.telefono << endl;
+    solicitarString("Nuevo telfono (ENTER para mantener): ", temp.telefono, 20);
+    if (strlen(temp.telefono) == 0)
+        strcpy(temp.telefono, original.telefono);
+
+    // --- Email ---
+    cout << "\nEmail actual: " << temp.email << endl;
+    solicitarString("Nuevo email (ENTER para mantener): ", temp.email, 100);
+    if (strlen(temp.email) == 0)
+        strcpy(temp.email, original.email);
+    else if (!emailValido(temp.email)) {
+        cout << "ERROR: El email debe contener '@' y un dominio.\n";
+        return;
+    }
+
+    // --- Direccin ---
+    cout << "\nDireccin actual: " << temp.direccion << endl;
+    solicitarString("Nueva direccin (ENTER para mantener): ", temp.direccion, 200);
+    if (strlen(temp.direccion) == 0)
+        strcpy(temp.direccion, original.direccion);
+
+    // --- Confirmacin final ---
+    cout << "\n=== NUEVOS DATOS DEL PROVEEDOR ===\n";
+    mostrarProveedor(temp);
+
+    if (!confirmar("Guardar cambios? (S/N): "))
+        return;
+
+    reemplazarProveedor(tienda, index, temp);
+    if (confirmarCambios(tienda))
+        cout << "Proveedor actualizado exitosamente.\n";
+}
+
+//2.3.4
+
+// Listado de proveedores en orden de registro o de nombre
+bool tablaProveedoresEnOrden(Tienda* tienda, FILE* destino, int desde, int limite, int campo, bool descendente) {
+    const IndiceOrden* orden = campo == ORDEN_NOMBRE ? ordenProveedores(tienda) : nullptr;
+    SalidaTabla s;
+    iniciarSalidaTabla(&s, destino, COLUMNAS_PROVEEDORES, sizeof(COLUMNAS_PROVEEDORES) / sizeof(ColumnaTabla));
+    encabezadoTabla(&s, "LISTADO DE PROVEEDORES");
+    paraCadaEnListado(orden, tienda->proveedores, descendente, desde, limite, [&](Proveedor& p, int) {
+        filaProveedor(&s, p);
+    });
+    pieTabla(&s);
+    return terminarSalidaTabla(&s);
+}
+
+bool tablaProveedores(Tienda* tienda, FILE* destino, int desde, int limite) {
+    return tablaProveedoresEnOrden(tienda, destino, desde, limite, ORDEN_REGISTRO, false);
+}
+
+// Totales de inventario de cada proveedor
+const ColumnaTabla COLUMNAS_TOTALES[] = {
+    {"ID", 6}, {"Proveedor", 24}, {"Productos", 10}, {"Unidades", 14}, {"Valor", 18}
+};
+
+bool tablaTotalesProveedores(Tienda* tienda, FILE* destino, int desde, int limite) {
+    SalidaTabla s;
+    iniciarSalidaTabla(&s, destino, COLUMNAS_TOTALES, sizeof(COLUMNAS_TOTALES) / sizeof(ColumnaTabla));
+    encabezadoTabla(&s, "INVENTARIO POR PROVEEDOR");
+    paraCadaActivoEnVentana(tienda->proveedores, desde, limite, [&](Proveedor& p, int) {
+        TotalesInventario t = totalesProveedor(tienda, p.id);
+        celdaEntero(&s, 0, p.id);
+        celdaTexto(&s, 1, p.nombre);
+        celdaEntero(&s, 2, t.productos);
+        celdaEntero(&s, 3, t.unidades);
+        celdaCentavos(&s, 4, t.valorCentavos);
+    });
+    pieTabla(&s);
+    return terminarSalidaTabla(&s);
+}
+
+void resumenInventario(Tienda* tienda) {
+    const TotalesInventario& global = agregadosDeInventario(tienda)->global;
+    cout << "\n=== RESUMEN DE INVENTARIO ===\n";
+    cout << "Productos: " << global.productos << "\n";
+    cout << "Unidades en stock: " << global.unidades << "\n";
+    cout << "Valor del inventario: " << fixed << setprecision(2)
+         << global.valorCentavos / 100.0 << "\n\n";
+
+    int proveedores = activosEnTabla(tienda->proveedores);
+    if (proveedores > 0)
+        mostrarPorPaginas(tienda, tablaTotalesProveedores, proveedores, "proveedores");
+}
+
+void listarProveedores(Tienda* tienda) {
+    int activos = activosEnTabla(tienda->proveedores);
+    if (activos == 0) {
+        cout << "No hay proveedores registrados.\n";
+        return;
+    }
+
+    int campo;
+    bool descendente;
+    solicitarOrden(false, &campo, &descendente);
+    mostrarPorPaginas(tienda, [&](Tienda* t, FILE* destino, int desde, int limite) {
+        return tablaProveedoresEnOrden(t, destino, desde, limite, campo, descendente);
+    }, activos, "proveedores");
+}
+
+//2.3.5
+
+void eliminarProveedor(Tienda* tienda) {
+    int id;
+    cout << "Ingrese el ID del proveedor a eliminar (0 para cancelar): ";
+    cin >> id;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    if (id == 0)
+        return;
+
+    int index = buscarProveedorPorID(tienda, id);
+    if (index == -1) {
+        cout << "ERROR: No existe un proveedor con ese ID.\n";
+        return;
+    }
+
+    Proveedor& p = tienda->proveedores[index];
+
+    cout << "\n=== PROVEEDOR A ELIMINAR ===\n";
+    mostrarProveedor(p);
+
+    // --- Verificar si tiene productos asociados ---
+    bool tieneProductos = productosDeProveedor(tienda, id) != nullptr;
+
+    if (tieneProductos) {
+        cout << "\nADVERTENCIA: Este proveedor tiene productos asociados.\n";
+        cout << "No se puede eliminar mientras existan productos vinculados.\n";
+        return;
+    }
+
+    // --- Confirmacin ---
+    if (!confirmar("\nEliminar proveedor? (S/N): ")) {
+        cout << "Eliminacin cancelada.\n";
+        return;
+    }
+
+    quitarProveedor(tienda, index);
+
+    if (confirmarCambios(tienda))
+        cout << "Proveedor eliminado exitosamente.\n";
+
+    compactarSiHaceFalta(tienda);
+}
+
+//=======================
+//2.4
+//=======================
+
+void crearCliente(Tienda* tienda) {
+    if (!confirmar("Desea registrar un nuevo cliente? (S/N): "))
+        return;
+
+    Cliente nuevo;
+
+    // --- Cdula / RIF ---
+    solicitarString(
+        "Ingrese cdula/RIF del cliente (o CANCELAR): ",
+        nuevo.cedula,
+        20
+    );
+
+    if (strcmp(nuevo.cedula, "CANCELAR") == 0 || strcmp(nuevo.cedula, "0") == 0)
+        return;
+
+    if (clienteDuplicado(tienda, nuevo.cedula)) {
+        cout << "ERROR: La cdula/RIF '" << nuevo.cedula << "' ya est registrada.\n";
+        return;
+    }
+
+    // --- Nombre ---
+    solicitarString("Ingrese nombre del cliente (o CANCELAR): ",
+                    nuevo.nombre, 100);
+
+    if (strcmp(nuevo.nombre, "CANCELAR") == 0 || strcmp(nuevo.nombre, "0") == 0)
+        return;
+
+    // --- Email ---
+    solicitarString(
+        "Ingrese email del cliente (o CANCELAR): ",
+        nuevo.email,
+        100,
+        emailValido,
+        "ERROR: El email debe contener '@' y un punto.\n"
+    );
+
+    if (strcmp(nuevo.email, "CANCELAR") == 0 || strcmp(nuevo.email, "0") == 0)
+        return;
+
+    // --- Telfono ---
+    solicitarString("Ingrese telfono del cliente (o CANCELAR): ",
+                    nuevo.telefono, 20);
+
+    if (strcmp(nuevo.telefono, "CANCELAR") == 0 || strcmp(nuevo.telefono, "0") == 0)
+        return;
+
+    // --- Direccin ---
+    solicitarString("Ingrese direccin del cliente (o CANCELAR): ",
+                    nuevo.direccion, 200);
+
+    if (strcmp(nuevo.direccion, "CANCELAR") == 0 || strcmp(nuevo.direccion, "0") == 0)
+        return;
+
+    // --- Fecha automtica ---
+    nuevo.fechaRegistro = fechaActual();
+
+    // --- Resumen ---
+    cout << "\n=== RESUMEN DEL CLIENTE ===\n";
+    cout << "Cdula/RIF: " << nuevo.cedula << endl;
+    cout << "Nombre: " << nuevo.nombre << endl;
+    cout << "Email: " << nuevo.email << endl;
+    cout << "Telfono: " << nuevo.telefono << endl;
+    cout << "Direccin: " << nuevo.direccion << endl;
+
+    if (!confirmar("Guardar cliente? (S/N): "))
+        return;
+
+    // --- Guardar ---
+    nuevo.id = tienda->siguienteIdCliente++;
+    agregarCliente(tienda, nuevo);
+
+    if (confirmarCambios(tienda))
+        cout << "Cliente registrado exitosamente.\n";
+}
+
+//2.4.2
+
+void buscarCliente(Tienda* tienda) {
+    int opcion;
+
+    do {
+        cout << "\n=== BUSCAR CLIENTE ===\n";
+        cout << "1. Buscar por ID\n";
+        cout << "2. Buscar por nombre (coincidencia parcial)\n";
+        cout << "3. Buscar por cdula/RIF\n";
+        cout << "0. Cancelar\n";
+        cout << "Seleccione una opcin: ";
+        cin >> opcion;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        if (opcion == 0)
+            return;
+
+        int index = -1;
+
+        switch (opcion) {
+
+            case 1: {
+                int id;
+                cout << "Ingrese ID del cliente: ";
+                cin >> id;
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+                index = buscarClientePorID(tienda, id);
+                break;
+            }
+
+            case 2: {
+                char nombre[100];
+                solicitarString("Ingrese nombre o parte del nombre: ", nombre, 100);
+                index = buscarClientePorNombre(tienda, nombre);
+                break;
+            }
+
+            case 3: {
+                char cedula[20];
+                solicitarString("Ingrese cdula/RIF del cliente: ", cedula, 20);
+                index = buscarClientePorCedula(tienda, cedula);
+                break;
+            }
+
+            default:
+                cout << "Opcin invlida.\n";
+                continue;
+        }
+
+        if (index == -1) {
+            cout << "No se encontr ningn cliente con ese criterio.\n";
+        } else {
+            mostrarCliente(tienda->clientes[index]);
+        }
+
+        system("pause");
+
+    } while (opcion != 0);
+}
+
+//2.4.3
+
+void actualizarCliente(Tienda* tienda) {
+    int id;
+    cout << "Ingrese el ID del cliente a actualizar (0 para cancelar): ";
+    cin >> id;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    if (id == 0)
+        return;
+
+    int index = buscarClientePorID(tienda, id);
+    if (index == -1) {
+        cout << "ERROR: No existe un cliente con ese ID.\n";
+        return;
+    }
+
+    Cliente& original = tienda->clientes[index];
+    Cliente temp = original; // copia temporal
+
+    cout << "\n=== CLIENTE ENCONTRADO ===\n";
+    mostrarCliente(original);
+
+    if (!confirmar("\nDesea modificar este cliente? (S/N): "))
+        return;
+
+    // --- Nombre ---
+    cout << "\nNombre actual: " << temp.nombre << endl;
+    solicitarString("Nuevo nombre (ENTER para mantener): ", temp.nombre, 100);
+    if (strlen(temp.nombre) == 0)
+        strcpy(temp.nombre, original.nombre);
+
+    // --- Cdula/RIF ---
+    cout << "\nCdula/RIF actual: " << temp.cedula << endl;
+    solicitarString("Nueva cdula/RIF (ENTER para mantener): ", temp.cedula, 20);
+    if (strlen(temp.cedula) == 0)
+        strcpy(temp.cedula, original.cedula);
+    else if (clienteDuplicado(tienda, temp.cedula, original.id)) {
+        cout << "ERROR: La cdula/RIF '" << temp.cedula << "' ya est registrada.\n";
+        return;
+    }
+
+    // --- Telfono ---
+    cout << "\nTelfono actual: " << temp.telefono << endl;
+    solicitarString("Nuevo telfono (ENTER para mantener): ", temp.telefono, 20);
+    if (strlen(temp.telefono) == 0)
+        strcpy(temp.telefono, original.telefono);
+
+    // --- Email ---
+    cout << "\nEmail actual: " << temp.email << endl;
+    solicitarString("Nuevo email (ENTER para mantener): ", temp.email, 100);
+    if (strlen(temp.email) == 0)
+        strcpy(temp.email, original.email);
+    else if (!emailValido(temp.email)) {
+        cout << "ERROR: El email debe contener '@' y un dominio.\n";
+        return;
+    }
+
+    // --- Direccin ---
+    cout << "\nDireccin actual: " << temp.direccion << endl;
+    solicitarString("Nueva direccin (ENTER para mantener): ", temp.direccion, 200);
+    if (strlen(temp.direccion) == 0)
+        strcpy(temp.direccion, original.direccion);
+
+    // --- Confirmacin final ---
+    cout << "\n=== NUEVOS DATOS DEL CLIENTE ===\n";
+    mostrarCliente(temp);
+
+    if (!confirmar("Guardar cambios? (S/N): "))
+        return;
+
+    reemplazarCliente(tienda, index, temp);
+
+    if (confirmarCambios(tienda))
+        cout << "Cliente actualizado exitosamente.\n";
+}
+
+//2.4.4
+
+// Listado de clientes en orden de registro o de nombre
+bool tablaClientesEnOrden(Tienda* tienda, FILE* destino, int desde, int limite, int campo, bool descendente) {
+    const IndiceOrden* orden = campo == ORDEN_NOMBRE ? ordenClientes(tienda) : nullptr;
+    SalidaTabla s;
+    iniciarSalidaTabla(&s, destino, COLUMNAS_CLIENTES, sizeof(COLUMNAS_CLIENTES) / sizeof(ColumnaTabla));
+    encabezadoTabla(&s, "LISTADO DE CLIENTES");
+    paraCadaEnListado(orden, tienda->clientes, descendente, desde, limite, [&](Cliente& c, int) {
+        filaCliente(&s, c);
+    });
+    pieTabla(&s);
+    return terminarSalidaTabla(&s);
+}
+
+bool tablaClientes(Tienda* tienda, FILE* destino, int desde, int limite) {
+    return tablaClientesEnOrden(tienda, destino, desde, limite, ORDEN_REGISTRO, false);
+}
+
+void listarClientes(Tienda* tienda) {
+    int activos = activosEnTabla(tienda->clientes);
+    if (activos == 0) {
+        cout << "No hay clientes registrados.\n";
+        return;
+    }
+
+    int campo;
+    bool descendente;
+    solicitarOrden(false, &campo, &descendente);
+    mostrarPorPaginas(tienda, [&](Tienda* t, FILE* destino, int desde, int limite) {
+        return tablaClientesEnOrden(t, destino, desde, limite, campo, descendente);
+    }, activos, "clientes");
+}
+
+//2.4.5
+
+void eliminarCliente(Tienda* tienda) {
+    int id;
+    cout << "Ingrese el ID del cliente a eliminar (0 para cancelar): ";
+    cin >> id;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    if (id == 0)
+        return;
+
+    int index = buscarClientePorID(tienda, id);
+    if (index == -1) {
+        cout << "ERROR: No existe un cliente con ese ID.\n";
+        return;
+    }
+
+    Cliente& c = tienda->clientes[index];
+
+    cout << "\n=== CLIENTE A ELIMINAR ===\n";
+    mostrarCliente(c);
+
+    // Verificar transacciones asociadas
+    bool tieneTransacciones = false;
+    for (int i = 0; i < tienda->transacciones.num; i++) {
+        if (tienda->transacciones[i].idRelacionado == id &&
+            strcmp(tienda->transacciones[i].tipo, "VENTA") == 0) {
+            tieneTransacciones = true;
+            break;
+        }
+    }
+
+    if (tieneTransacciones) {
+        cout << "\nADVERTENCIA: Este cliente tiene transacciones asociadas.\n";
+        cout << "No se puede eliminar mientras existan ventas registradas.\n";
+        return;
+    }
+
+    if (!confirmar("\nEliminar cliente? (S/N): ")) {
+        cout << "Eliminacin cancelada.\n";
+        return;
+    }
+
+    quitarCliente(tienda, index);
+
+    if (confirmarCambios(tienda))
+        cout << "Cliente eliminado exitosamente.\n";
+
+    compactarSiHaceFalta(tienda);
+}
+
+
+//======================
+//2.5 transacciones
+//======================
+
+enum TipoTicket { TICKET_COMPRA, TICKET_VENTA };
+
+struct LineaTicket {
+    int idProducto;
+    int cantidad;
+    float precioUnitario;      // <= 0: se usa el precio del producto
+};
+
+// Un ticket es una compra a un proveedor o una venta a un cliente con una o
+// ms lneas
+struct Ticket {
+    int tipo;                  // TipoTicket
+    int idRelacionado;         // ID del proveedor (compra) o cliente (venta)
+    const LineaTicket* lineas;
+    int numLineas;
+    const char* descripcion;   // opcional
+};
+
+// Valida y asienta un lote de tickets de una sola vez. Si algn ticket no es
+// vlido (proveedor/cliente o producto inexistente, cantidad no positiva o
+// stock insuficiente, contando lo que ya movieron los tickets anteriores del
+// lote) no se asienta nada, se explica en 'motivo' y se devuelve false.
+bool procesarTickets(Tienda* tienda, const Ticket* tickets, int numTickets,
+                     char* motivo, int tamMotivo) {
+    int totalLineas = 0;
+    for (int t = 0; t < numTickets; t++)
+        totalLineas += tickets[t].numLineas;
+
+    if (totalLineas == 0) {
+        snprintf(motivo, tamMotivo, "El lote no tiene lneas");
+        return false;
+    }
+    if (totalLineas > (int)(MAX_PAYLOAD_CAMBIO / sizeof(Transaccion))) {
+        snprintf(motivo, tamMotivo, "El lote tiene demasiadas lneas (mximo %d)",
+                 (int)(MAX_PAYLOAD_CAMBIO / sizeof(Transaccion)));
+        return false;
+    }
+
+    Transaccion* lineas = new Transaccion[totalLineas];
+    int* indices = new int[totalLineas];
+    int hoy = fechaActual();
+
+    // Primera pasada: validar y armar las transacciones. El stock se mueve de
+    // forma provisional para que cada lnea vea lo que dejaron las anteriores.
+    int n = 0;
+    bool ok = true;
+    for (int t = 0; t < numTickets && ok; t++) {
+        const Ticket& ticket = tickets[t];
+        bool compra = ticket.tipo == TICKET_COMPRA;
+
+        if (compra ? !existeProveedor(tienda, ticket.idRelacionado)
+                   : buscarClientePorID(tienda, ticket.idRelacionado) == -1) {
+            snprintf(motivo, tamMotivo, "Ticket %d: el %s con ID %d no existe", t + 1,
+                     compra ? "proveedor" : "cliente", ticket.idRelacionado);
+            ok = false;
+            break;
+        }
+
+        for (int l = 0; l < ticket.numLineas; l++) {
+            const LineaTicket& linea = ticket.lineas[l];
+            int index = buscarProductoPorID(tienda, linea.idProducto);
+            if (index == -1) {
+                snprintf(motivo, tamMotivo, "Ticket %d, lnea %d: el producto con ID %d no existe",
+                         t + 1, l + 1, linea.idProducto);
+                ok = false;
+                break;
+            }
+            if (linea.cantidad <= 0) {
+                snprintf(motivo, tamMotivo, "Ticket %d, lnea %d: cantidad invlida (%d)",
+                         t + 1, l + 1, linea.cantidad);
+                ok = false;
+                break;
+            }
+
+            Producto& p = tienda->productos[index];
+            if (!compra && p.stock < linea.cantidad) {
+                snprintf(motivo, tamMotivo,
+                         "Ticket %d, lnea %d: stock insuficiente de '%.40s'. Disponible: %d, Solicitado: %d",
+                         t + 1, l + 1, p.nombre, p.stock, linea.cantidad);
+                ok = false;
+                break;
+            }
+            if (compra && p.stock > INT_MAX - linea.cantidad) {
+                snprintf(motivo, tamMotivo, "Ticket %d, lnea %d: el stock de '%.40s' se desborda",
+                         t + 1, l + 1, p.nombre);
+                ok = false;
+                break;
+            }
+
+            Transaccion& tr = lineas[n];
+            memset(&tr, 0, sizeof(tr));
+            tr.id = tienda->siguienteIdTransaccion + n;
+            strcpy(tr.tipo, compra ? "COMPRA" : "VENTA");
+            tr.idProducto = linea.idProducto;
+            tr.idRelacionado = ticket.idRelacionado;
+            tr.cantidad = linea.cantidad;
+            tr.precioUnitario = linea.precioUnitario > 0 ? linea.precioUnitario : p.precio;
+            tr.total = tr.cantidad * tr.precioUnitario;
+            tr.fecha = hoy;
+            if (ticket.descripcion != nullptr)
+                strncpy(tr.descripcion, ticket.descripcion, sizeof(tr.descripcion) - 1);
+
+            p.stock += compra ? linea.cantidad : -linea.cantidad;
+            indices[n++] = index;
+        }
+    }
+
+    // Deshacer el movimiento provisional; si todo es vlido lo asienta
+    // asentarTransacciones junto con el historial y el WAL
+    for (int i = n - 1; i >= 0; i--) {
+        if (strcmp(lineas[i].tipo, "COMPRA") == 0)
+            tienda->productos[indices[i]].stock -= lineas[i].cantidad;
+        else
+            tienda->productos[indices[i]].stock += lineas[i].cantidad;
+    }
+
+    if (ok)
+        asentarTransacciones(tienda, lineas, n);
+
+    delete[] indices;
+    delete[] lineas;
+    return ok;
+}
+
+void mostrarTransaccion(const Transaccion& t) {
+    char fecha[LARGO_FECHA];
+    formatearFecha(t.fecha, fecha);
+    cout << "ID: " << t.id << " | " << t.tipo
+         << " | Producto: " << t.idProducto
+         << " | Relacionado: " << t.idRelacionado
+         << " | Cantidad: " << t.cantidad
+         << " | Precio: " << fixed << setprecision(2) << t.precioUnitario
+         << " | Total: " << t.total
+         << " | Fecha: " << fecha << endl;
+}
+
+// Pide un ticket por consola, lnea por lnea, y lo asienta
+void registrarTicket(Tienda* tienda, int tipo) {
+    bool compra = tipo == TICKET_COMPRA;
+    int idRelacionado;
+
+    if (compra) {
+        cout << "ID del proveedor (0 para cancelar): ";
+    } else {
+        cout << "ID del cliente (0 para cancelar): ";
+    }
+    cin >> idRelacionado;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (idRelacionado == 0)
+        return;
+
+    if (compra ? !existeProveedor(tienda, idRelacionado)
+               : buscarClientePorID(tienda, idRelacionado) == -1) {
+        cout << "ERROR: El " << (compra ? "proveedor" : "cliente")
+             << " con ID " << idRelacionado << " no existe.\n";
+        return;
+    }
+
+    int capacidad = 4, numLineas = 0;
+    LineaTicket* lineas = new LineaTicket[capacidad];
+    float total = 0;
+
+    while (true) {
+        int idProducto;
+        cout << "\nID del producto (0 para terminar): ";
+        cin >> idProducto;
+        if (idProducto == 0)
+            break;
+
+        int index = buscarProductoPorID(tienda, idProducto);
+        if (index == -1) {
+            cout << "ERROR: No existe un producto con ese ID.\n";
+            continue;
+        }
+
+        Producto& p = tienda->productos[index];
+        cout << "Producto: " << p.nombre << " | Stock: " << p.stock
+             << " | Precio: " << fixed << setprecision(2) << p.precio << endl;
+
+        if (numLineas >= capacidad) {
+            LineaTicket* nuevo = new LineaTicket[capacidad * 2];
+            for (int i = 0; i < numLineas; i++)
+                nuevo[i] = lineas[i];
+            delete[] lineas;
+            lineas = nuevo;
+            capacidad *= 2;
+        }
+
+        LineaTicket& linea = lineas[numLineas++];
+        linea.idProducto = idProducto;
+        linea.cantidad = solicitarEnteroPositivo("Cantidad: ");
+        linea.precioUnitario = p.precio;
+        total += linea.cantidad * linea.precioUnitario;
+    }
+
+    if (numLineas == 0) {
+        cout << "Ticket vaco, no se registr nada.\n";
+        delete[] lineas;
+        return;
+    }
+
+    cout << "\nLneas: " << numLineas << " | Total: " << fixed << setprecision(2) << total << endl;
+    if (!confirmar(compra ? "Registrar compra? (S/N): " : "Registrar venta? (S/N): ")) {
+        cout << "Operacin cancelada.\n";
+        delete[] lineas;
+        return;
+    }
+
+    Ticket ticket;
+    ticket.tipo = tipo;
+    ticket.idRelacionado = idRelacionado;
+    ticket.lineas = lineas;
+    ticket.numLineas = numLineas;
+    ticket.descripcion = nullptr;
+
+    char motivo[200];
+    if (!procesarTickets(tienda, &ticket, 1, motivo, sizeof(motivo)))
+        cout << "ERROR: " << motivo << ".\n";
+    else if (confirmarCambios(tienda))
+        cout << (compra ? "Compra" : "Venta") << " registrada exitosamente.\n";
+
+    delete[] lineas;
+}
+
+void listarTransacciones(Tienda* tienda) {
+    if (tienda->transacciones.num == 0) {
+        cout << "No hay transacciones registradas.\n";
+        return;
+    }
+
+    for (int i = 0; i < tienda->transacciones.num; i++)
+        mostrarTransaccion(tienda->transacciones[i]);
+
+    cout << "\nTotal de transacciones: " << tienda->transacciones.num << "\n";
+}
+
+void transaccionesPorFecha(Tienda* tienda) {
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    int desde = solicitarFecha("Desde (YYYY-MM-DD): ");
+    int hasta = solicitarFecha("Hasta (YYYY-MM-DD): ");
+
+    int numResultados;
+    int* resultados = transaccionesEntre(tienda, desde, hasta, &numResultados);
+
+    if (numResultados == 0) {
+        cout << "No hay transacciones en ese rango.\n";
+        return;
+    }
+
+    for (int i = 0; i < numResultados; i++)
+        mostrarTransaccion(tienda->transacciones[resultados[i]]);
+
+    cout << "\nTotal de transacciones: " << numResultados << "\n";
+    delete[] resultados;
+}
+
+// Reportes de ventas
+
+const int TOP_MAS_VENDIDOS = 10;
+
+const ColumnaTabla COLUMNAS_VENTAS_DIA[] = {
+    {"Fecha", 10}, {"Ventas", 8}, {"Unidades", 10}, {"Ingresos", 14},
+    {"Compras", 8}, {"Unidades", 10}, {"Egresos", 14}
+};
+
+const ColumnaTabla COLUMNAS_AGRUPADAS[] = {
+    {"ID", 6}, {"Nombre", 28}, {"Lneas", 8}, {"Unidades", 12}, {"Monto", 16}
+};
+
+// Un da por fila, solo los que tuvieron movimiento
+bool tablaVentasPorDia(Tienda* tienda, FILE* destino, int desde, int hasta) {
+    SalidaTabla s;
+    iniciarSalidaTabla(&s, destino, COLUMNAS_VENTAS_DIA, sizeof(COLUMNAS_VENTAS_DIA) / sizeof(ColumnaTabla));
+    encabezadoTabla(&s, "VENTAS POR DA");
+    TotalesDia suma;
+    memset(&suma, 0, sizeof(suma));
+    for (int fecha = desde; fecha <= hasta; fecha++) {
+        TotalesDia d = totalesDelDia(tienda, fecha);
+        if (d.ventas.lineas == 0 && d.compras.lineas == 0) continue;
+
+        char texto[LARGO_FECHA];
+        formatearFecha(fecha, texto);
+        celdaTexto(&s, 0, texto);
+        celdaEntero(&s, 1, d.ventas.lineas);
+        celdaEntero(&s, 2, d.ventas.unidades);
+        celdaCentavos(&s, 3, d.ventas.centavos);
+        celdaEntero(&s, 4, d.compras.lineas);
+        celdaEntero(&s, 5, d.compras.unidades);
+        celdaCentavos(&s, 6, d.compras.centavos);
+
+        suma.ventas.lineas += d.ventas.lineas;
+        suma.ventas.unidades += d.ventas.unidades;
+        suma.ventas.centavos += d.ventas.centavos;
+        suma.compras.lineas += d.compras.lineas;
+        suma.compras.unidades += d.compras.unidades;
+        suma.compras.centavos += d.compras.centavos;
+    }
+    lineaTabla(&s, false, true);
+    celdaTexto(&s, 0, "Total");
+    celdaEntero(&s, 1, suma.ventas.lineas);
+    celdaEntero(&s, 2, suma.ventas.unidades);
+    celdaCentavos(&s, 3, suma.ventas.centavos);
+    celdaEntero(&s, 4, suma.compras.lineas);
+    celdaEntero(&s, 5, suma.compras.unidades);
+    celdaCentavos(&s, 6, suma.compras.centavos);
+    pieTabla(&s);
+    return terminarSalidaTabla(&s);
+}
+
+// Grupos de un reporte; 'porProducto' decide de dnde sale el nombre
+bool tablaAgrupada(Tienda* tienda, FILE* destino, const char* titulo,
+                   const TotalAgrupado* grupos, int num, bool porProducto) {
+    SalidaTabla s;
+    iniciarSalidaTabla(&s, destino, COLUMNAS_AGRUPADAS, sizeof(COLUMNAS_AGRUPADAS) / sizeof(ColumnaTabla));
+    encabezadoTabla(&s, titulo);
+    for (int i = 0; i < num; i++) {
+        const char* nombre;
+        if (porProducto) {
+            int index = buscarProductoPorID(tienda, grupos[i].clave);
+            nombre = index == -1 ? "(eliminado)" : tienda->productos[index].nombre;
+        } else {
+            nombre = obtenerNombreProveedor(tienda, grupos[i].clave);
+        }
+        celdaEntero(&s, 0, grupos[i].clave);
+        celdaTexto(&s, 1, nombre);
+        celdaEntero(&s, 2, grupos[i].total.lineas);
+        celdaEntero(&s, 3, grupos[i].total.unidades);
+        celdaCentavos(&s, 4, grupos[i].total.centavos);
+    }
+    pieTabla(&s);
+    return terminarSalidaTabla(&s);
+}
+
+void reportesDeVentas(Tienda* tienda) {
+    int opcion;
+    cout << "\n=== REPORTES DE VENTAS ===\n";
+    cout << "1. Ventas por da\n";
+    cout << "2. Productos ms vendidos (unidades)\n";
+    cout << "3. Productos ms vendidos (ingresos)\n";
+    cout << "4. Compras por proveedor\n";
+    cout << "0. Cancelar\n";
+    cout << "Seleccione una opcin: ";
+    cin >> opcion;
+
+    if (opcion < 1 || opcion > 4) return;
+
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    int desde = solicitarFecha("Desde (YYYY-MM-DD): ");
+    int hasta = solicitarFecha("Hasta (YYYY-MM-DD): ");
+
+    if (opcion == 1) {
+        tablaVentasPorDia(tienda, stdout, desde, hasta);
+        return;
+    }
+
+    int num;
+    TotalAgrupado* grupos;
+    if (opcion == 4)
+        grupos = comprasPorProveedor(tienda, desde, hasta, &num);
+    else
+        grupos = productosMasVendidos(tienda, desde, hasta, TOP_MAS_VENDIDOS, opcion == 3, &num);
+
+    if (num == 0) {
+        cout << "No hay " << (opcion == 4 ? "compras" : "ventas") << " en ese rango.\n";
+        return;
+    }
+
+    tablaAgrupada(tienda, stdout, opcion == 4 ? "COMPRAS POR PROVEEDOR" : "PRODUCTOS MS VENDIDOS",
+                  grupos, num, opcion != 4);
+    delete[] grupos;
+}
+
+
+//======================
+//3.1 snapshot binario
+//======================
+
+const char ARCHIVO_SNAPSHOT[] = "tienda.dat";
+const char MAGIA_SNAPSHOT[8] = { 'T', 'I', 'E', 'N', 'D', 'A', 'S', 'N' };
+const int VERSION_SNAPSHOT = 4;
+const int ALINEACION_SNAPSHOT = 64;
+
+// Cabecera del archivo. Detrs van los arrays de registros tal cual estn en
+// memoria, cada uno alineado a ALINEACION_SNAPSHOT, para poder usarlos en el
+// sitio despus de mapear el archivo.
+struct CabeceraSnapshot {
+    char magia[8];             // MAGIA_SNAPSHOT
+    int version;               // VERSION_SNAPSHOT
+    int tamCabecera;           // sizeof(CabeceraSnapshot)
+
+    // Si algn struct cambia de tamao el snapshot deja de ser compatible
+    int tamProducto;
+    int tamProveedor;
+    int tamCliente;
+    int tamTransaccion;
+
+    char nombre[100];
+    char rif[20];
+
+    int numProductos;
+    int capacidadProductos;
+    int numProveedores;
+    int capacidadProveedores;
+    int numClientes;
+    int capacidadClientes;
+    int numTransacciones;
+    int capacidadTransacciones;
+
+    int siguienteIdProducto;
+    int siguienteIdProveedor;
+    int siguienteIdCliente;
+    int siguienteIdTransaccion;
+
+    // Posicin de cada array dentro del archivo
+    long long offsetProductos;
+    long long offsetProveedores;
+    long long offsetClientes;
+    long long offsetTransacciones;
+
+    long long lsn;             // ltimo cambio del WAL incluido en el snapshot
+};
+
+// Registros de versiones anteriores, para convertir snapshots y WAL viejos.
+// En la 2 las fechas eran texto "YYYY-MM-DD"; la 3 las pas a das; la 4
+// agreg stockMinimo a Producto.
+struct ProductoV2 {
+    int id;
+    char codigo[20];
+    char nombre[100];
+    char descripcion[200];
+    int idProveedor;
+    float precio;
+    int stock;
+    char fechaRegistro[11];
+};
+
+struct ProductoV3 {
+    int id;
+    char codigo[20];
+    char nombre[100];
+    char descripcion[200];
+    int idProveedor;
+    float precio;
+    int stock;
+    int fechaRegistro;
+};
+
+struct ProveedorV2 {
+    int id;
+    char nombre[100];
+    char rif[20];
+    char telefono[20];
+    char email[100];
+    char direccion[200];
+    char fechaRegistro[11];
+};
+
+struct ClienteV2 {
+    int id;
+    char nombre[100];
+    char cedula[20];
+    char telefono[20];
+    char email[100];
+    char direccion[200];
+    char fechaRegistro[11];
+};
+
+struct TransaccionV2 {
+    int id;
+    char tipo[10];
+    int idProducto;
+    int idRelacionado;
+    int cantidad;
+    float precioUnitario;
+    float total;
+    char fecha[11];
+    char descripcion[200];
+};
+
+// Las fechas que no se pueden leer quedan en el da 0 (1970-01-01)
+int fechaDeVersion2(const char* texto) {
+    char fecha[11];
+    memcpy(fecha, texto, sizeof(fecha));
+    fecha[10] = '\0';
+    int dias;
+    return parsearFecha(fecha, &dias) ? dias : 0;
+}
+
+template <typename T>
+void convertirRegistro(const T& viejo, T* r) {
+    *r = viejo;
+}
+
+void convertirRegistro(const ProductoV3& v, Producto* p) {
+    memset(p, 0, sizeof(*p));
+    p->id = v.id;
+    memcpy(p->codigo, v.codigo, sizeof(p->codigo));
+    memcpy(p->nombre, v.nombre, sizeof(p->nombre));
+    memcpy(p->descripcion, v.descripcion, sizeof(p->descripcion));
+    p->idProveedor = v.idProveedor;
+    p->precio = v.precio;
+    p->stock = v.stock;
+    p->fechaRegistro = v.fechaRegistro;
+    p->stockMinimo = 0;
+}
+
+void convertirRegistro(const ProductoV2& v, Producto* p) {
+    ProductoV3 v3;
+    memset(&v3, 0, sizeof(v3));
+    v3.id = v.id;
+    memcpy(v3.codigo, v.codigo, sizeof(v3.codigo));
+    memcpy(v3.nombre, v.nombre, sizeof(v3.nombre));
+    memcpy(v3.descripcion, v.descripcion, sizeof(v3.descripcion));
+    v3.idProveedor = v.idProveedor;
+    v3.precio = v.precio;
+    v3.stock = v.stock;
+    v3.fechaRegistro = fechaDeVersion2(v.fechaRegistro);
+    convertirRegistro(v3, p);
+}
+
+void convertirRegistro(const ProveedorV2& v, Proveedor* p) {
+    memset(p, 0, sizeof(*p));
+    p->id = v.id;
+    memcpy(p->nombre, v.nombre, sizeof(p->nombre));
+    memcpy(p->rif, v.rif, sizeof(p->rif));
+    memcpy(p->telefono, v.telefono, sizeof(p->telefono));
+    memcpy(p->email, v.email, sizeof(p->email));
+    memcpy(p->direccion, v.direccion, sizeof(p->direccion));
+    p->fechaRegistro = fechaDeVersion2(v.fechaRegistro);
+}
+
+void convertirRegistro(const ClienteV2& v, Cliente* c) {
+    memset(c, 0, sizeof(*c));
+    c->id = v.id;
+    memcpy(c->nombre, v.nombre, sizeof(c->nombre));
+    memcpy(c->cedula, v.cedula, sizeof(c->cedula));
+    memcpy(c->telefono, v.telefono, sizeof(c->telefono));
+    memcpy(c->email, v.email, sizeof(c->email));
+    memcpy(c->direccion, v.direccion, sizeof(c->direccion));
+    c->fechaRegistro = fechaDeVersion2(v.fechaRegistro);
+}
+
+void convertirRegistro(const TransaccionV2& v, Transaccion* t) {
+    memset(t, 0, sizeof(*t));
+    t->id = v.id;
+    memcpy(t->tipo, v.tipo, sizeof(t->tipo));
+    t->idProducto = v.idProducto;
+    t->idRelacionado = v.idRelacionado;
+    t->cantidad = v.cantidad;
+    t->precioUnitario = v.precioUnitario;
+    t->total = v.total;
+    t->fecha = fechaDeVersion2(v.fecha);
+    memcpy(t->descripcion, v.descripcion, sizeof(t->descripcion));
+}
+
+// Tamao en disco de un T en la versin 'version' (V2 y V3 son su forma en
+// la 2 y la 3); 0 si la versin no se puede leer
+template <typename T, typename V2, typename V3>
+unsigned int tamEnVersion(int version) {
+    if (version == 2) return sizeof(V2);
+    if (version == 3) return sizeof(V3);
+    if (version == VERSION_SNAPSHOT) return sizeof(T);
+    return 0;
+}
+
+template <typename V, typename T>
+void leerComo(const char* datos, T* r) {
+    V viejo;
+    memcpy(&viejo, datos, sizeof(viejo));
+    convertirRegistro(viejo, r);
+}
+
+// Lee un registro de tamEnVersion bytes guardado en la versin 'version'
+template <typename T, typename V2, typename V3>
+void leerEnVersion(const char* datos, int version, T* r) {
+    if (version == 2)
+        leerComo<V2>(datos, r);
+    else if (version == 3)
+        leerComo<V3>(datos, r);
+    else
+        leerComo<T>(datos, r);
+}
+
+// Llena una tabla vaca con 'num' registros de una versin anterior
+template <typename T, typename V2, typename V3>
+void convertirTabla(Tabla<T>* t, const char* datos, int num, int version) {
+    unsigned int tam = tamEnVersion<T, V2, V3>(version);
+    reservarTabla(t, num);
+    for (int i = 0; i < num; i++) {
+        T r;
+        leerEnVersion<T, V2, V3>(datos + (size_t)i * tam, version, &r);
+        agregarEnTabla(t, r);
+    }
+}
+
+long long alinearOffset(long long offset) {
+    return (offset + ALINEACION_SNAPSHOT - 1) / ALINEACION_SNAPSHOT * ALINEACION_SNAPSHOT;
+}
+
+// Escribe ceros desde 'posicion' hasta 'offset' y luego el bloque de datos
+bool escribirBloqueSnapshot(FILE* f, long long* posicion, long long offset,
+                            const void* datos, long long bytes) {
+    static const char ceros[ALINEACION_SNAPSHOT] = {};
+
+    long long relleno = offset - *posicion;
+    if (relleno > 0 && fwrite(ceros, 1, (size_t)relleno, f) != (size_t)relleno)
+        return false;
+
+    if (bytes > 0 && fwrite(datos, 1, (size_t)bytes, f) != (size_t)bytes)
+        return false;
+
+    *posicion = offset + bytes;
+    return true;
+}
+
+// Escribe los primeros 'num' elementos de un array por segmentos como un solo
+// bloque contiguo
+template <typename T>
+bool escribirSegmentosSnapshot(FILE* f, long long* posicion, long long offset,
+                               const ArregloSegmentado<T>& a, int num) {
+    for (int i = 0; num > 0; i++) {
+        int cuantos = min(num, TAM_SEGMENTO);
+        if (!escribirBloqueSnapshot(f, posicion, i == 0 ? offset : *posicion,
+                                    a.segmentos[i], (long long)cuantos * sizeof(T)))
+            return false;
+        num -= cuantos;
+    }
+    if (*posicion < offset)
+        return escribirBloqueSnapshot(f, posicion, offset, nullptr, 0);
+    return true;
+}
+
+// Copia al heap los arrays que todava apuntan al snapshot y cierra la vista
+void desvincularSnapshot(Tienda* tienda) {
+    if (tienda->vistaSnapshot == nullptr) return;
+
+    desvincularSegmentos(tienda, &tienda->productos.registros);
+    desvincularSegmentos(tienda, &tienda->proveedores.registros);
+    desvincularSegmentos(tienda, &tienda->clientes.registros);
+    desvincularSegmentos(tienda, &tienda->transacciones.registros);
+
+    cerrarVistaSnapshot(tienda);
+}
+
+bool guardarSnapshot(Tienda* tienda, const char* ruta) {
+    // El snapshot nunca lleva lpidas
+    compactarTablas(tienda);
+
+    CabeceraSnapshot cab;
+    memset(&cab, 0, sizeof(cab));
+
+    memcpy(cab.magia, MAGIA_SNAPSHOT, sizeof(cab.magia));
+    cab.version = VERSION_SNAPSHOT;
+    cab.tamCabecera = sizeof(CabeceraSnapshot);
+    cab.tamProducto = sizeof(Producto);
+    cab.tamProveedor = sizeof(Proveedor);
+    cab.tamCliente = sizeof(Cliente);
+    cab.tamTransaccion = sizeof(Transaccion);
+
+    strcpy(cab.nombre, tienda->nombre);
+    strcpy(cab.rif, tienda->rif);
+
+    cab.numProductos = tienda->productos.num;
+    cab.capacidadProductos = tienda->productos.capacidad;
+    cab.numProveedores = tienda->proveedores.num;
+    cab.capacidadProveedores = tienda->proveedores.capacidad;
+    cab.numClientes = tienda->clientes.num;
+    cab.capacidadClientes = tienda->clientes.capacidad;
+    cab.numTransacciones = tienda->transacciones.num;
+    cab.capacidadTransacciones = tienda->transacciones.capacidad;
+
+    cab.siguienteIdProducto = tienda->siguienteIdProducto;
+    cab.siguienteIdProveedor = tienda->siguienteIdProveedor;
+    cab.siguienteIdCliente = tienda->siguienteIdCliente;
+    cab.siguienteIdTransaccion = tienda->siguienteIdTransaccion;
+    cab.lsn = tienda->lsn;
+
+    long long bytesProductos = (long long)tienda->productos.num * sizeof(Producto);
+    long long bytesProveedores = (long long)tienda->proveedores.num * sizeof(Proveedor);
+    long long bytesClientes = (long long)tienda->clientes.num * sizeof(Cliente);
+
+    cab.offsetProductos = alinearOffset(sizeof(CabeceraSnapshot));
+    cab.offsetProveedores = alinearOffset(cab.offsetProductos + bytesProductos);
+    cab.offsetClientes = alinearOffset(cab.offsetProveedores + bytesProveedores);
+    cab.offsetTransacciones = alinearOffset(cab.offsetClientes + bytesClientes);
+
+    // Se escribe en un temporal y se renombra: un corte a mitad de la
+    // escritura nunca deja el snapshot anterior a medias
+    char rutaTemporal[300];
+    snprintf(rutaTemporal, sizeof(rutaTemporal), "%s.tmp", ruta);
+
+    FILE* f = fopen(rutaTemporal, "wb");
+    if (f == nullptr) {
+        cout << "ERROR: No se pudo crear el archivo " << rutaTemporal << ".\n";
+        return false;
+    }
+
+    long long posicion = 0;
+    bool ok = escribirBloqueSnapshot(f, &posicion, 0, &cab, sizeof(cab)) &&
+              escribirSegmentosSnapshot(f, &posicion, cab.offsetProductos,
+                                        tienda->productos.registros, tienda->productos.num) &&
+              escribirSegmentosSnapshot(f, &posicion, cab.offsetProveedores,
+                                        tienda->proveedores.registros, tienda->proveedores.num) &&
+              escribirSegmentosSnapshot(f, &posicion, cab.offsetClientes,
+                                        tienda->clientes.registros, tienda->clientes.num) &&
+              escribirSegmentosSnapshot(f, &posicion, cab.offsetTransacciones,
+                                        tienda->transacciones.registros, tienda->transacciones.num) &&
+              sincronizarArchivo(f);
+
+    if (fclose(f) != 0)
+        ok = false;
+
+    if (!ok) {
+        remove(rutaTemporal);
+        cout << "ERROR: No se pudo escribir el snapshot.\n";
+        return false;
+    }
+
+#ifdef _WIN32
+    // Windows no deja reemplazar un archivo que tiene una vista abierta
+    desvincularSnapshot(tienda);
+    ok = MoveFileExA(rutaTemporal, ruta, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    ok = rename(rutaTemporal, ruta) == 0;
+#endif
+
+    if (!ok) {
+        remove(rutaTemporal);
+        cout << "ERROR: No se pudo reemplazar " << ruta << ".\n";
+        return false;
+    }
+
+    // Lo anotado hasta aqu ya est en el snapshot
+    if (tienda->wal != nullptr)
+        walTruncar(tienda->wal);
+
+    return true;
+}
+
+// Comprueba que un array del snapshot cabe dentro del archivo
+bool bloqueSnapshotValido(long long offset, int num, int tamRegistro, long long tamArchivo) {
+    if (num < 0 || offset < (long long)sizeof(CabeceraSnapshot)) return false;
+    if (offset % ALINEACION_SNAPSHOT != 0) return false;
+    return offset + (long long)num * tamRegistro <= tamArchivo;
+}
+
+// Abre un snapshot mapendolo en memoria. Los registros se usan en el sitio,
+// sin copiarlos; crecer agrega segmentos en el heap sin mover los mapeados.
+// Los de una versin anterior se convierten a tablas en el heap.
+// Devuelve la versin del archivo, 0 si no existe (o est vaco) o -1 si no
+// es un snapshot que se pueda leer.
+int cargarSnapshot(Tienda* tienda, const char* ruta) {
+    long long tam = 0;
+    char* vista = mapearArchivo(ruta, &tam);
+    if (vista == nullptr) {
+        FILE* f = fopen(ruta, "rb");
+        if (f == nullptr && errno == ENOENT)
+            return 0;
+        bool vacio = f != nullptr && fgetc(f) == EOF;
+        if (f != nullptr) fclose(f);
+        if (vacio)
+            return 0;
+        cerr << "ERROR: No se pudo abrir " << ruta << ".\n";
+        return -1;
+    }
+
+    CabeceraSnapshot cab;
+    bool valido = tam >= (long long)sizeof(CabeceraSnapshot);
+    if (valido) {
+        memcpy(&cab, vista, sizeof(cab));
+        int v = cab.version;
+        valido = memcmp(cab.magia, MAGIA_SNAPSHOT, sizeof(cab.magia)) == 0 &&
+                 cab.tamCabecera == (int)sizeof(CabeceraSnapshot) &&
+                 tamEnVersion<Producto, ProductoV2, ProductoV3>(v) != 0 &&
+                 cab.tamProducto == (int)tamEnVersion<Producto, ProductoV2, ProductoV3>(v) &&
+                 cab.tamProveedor == (int)tamEnVersion<Proveedor, ProveedorV2, Proveedor>(v) &&
+                 cab.tamCliente == (int)tamEnVersion<Cliente, ClienteV2, Cliente>(v) &&
+                 cab.tamTransaccion == (int)tamEnVersion<Transaccion, TransaccionV2, Transaccion>(v) &&
+                 bloqueSnapshotValido(cab.offsetProductos, cab.numProductos, cab.tamProducto, tam) &&
+                 bloqueSnapshotValido(cab.offsetProveedores, cab.numProveedores, cab.tamProveedor, tam) &&
+                 bloqueSnapshotValido(cab.offsetClientes, cab.numClientes, cab.tamCliente, tam) &&
+                 bloqueSnapshotValido(cab.offsetTransacciones, cab.numTransacciones, cab.tamTransaccion, tam);
+    }
+
+    if (!valido) {
+        desmapearArchivo(vista, tam);
+        cerr << "ERROR: " << ruta << " no es un snapshot vlido o es de una versin que no se puede leer. No se modific ningn archivo.\n";
+        return -1;
+    }
+
+    cab.nombre[sizeof(cab.nombre) - 1] = '\0';
+    cab.rif[sizeof(cab.rif) - 1] = '\0';
+    strcpy(tienda->nombre, cab.nombre);
+    strcpy(tienda->rif, cab.rif);
+
+    if (cab.version == VERSION_SNAPSHOT) {
+        tienda->vistaSnapshot = vista;
+        tienda->tamVistaSnapshot = tam;
+
+        // Los registros se usan en el sitio: cada segmento completo apunta al mapeo
+        mapearTabla(&tienda->productos, (Producto*)(vista + cab.offsetProductos), cab.numProductos);
+        mapearTabla(&tienda->proveedores, (Proveedor*)(vista + cab.offsetProveedores), cab.numProveedores);
+        mapearTabla(&tienda->clientes, (Cliente*)(vista + cab.offsetClientes), cab.numClientes);
+        mapearTabla(&tienda->transacciones, (Transaccion*)(vista + cab.offsetTransacciones),
+                    cab.numTransacciones);
+    } else {
+        tienda->vistaSnapshot = nullptr;
+        tienda->tamVistaSnapshot = 0;
+
+        iniciarTabla(&tienda->productos);
+        iniciarTabla(&tienda->proveedores);
+        iniciarTabla(&tienda->clientes);
+        iniciarTabla(&tienda->transacciones);
+        convertirTabla<Producto, ProductoV2, ProductoV3>(&tienda->productos, vista + cab.offsetProductos,
+                                                        cab.numProductos, cab.version);
+        convertirTabla<Proveedor, ProveedorV2, Proveedor>(&tienda->proveedores, vista + cab.offsetProveedores,
+                                                          cab.numProveedores, cab.version);
+        convertirTabla<Cliente, ClienteV2, Cliente>(&tienda->clientes, vista + cab.offsetClientes,
+                                                    cab.numClientes, cab.version);
+        convertirTabla<Transaccion, TransaccionV2, Transaccion>(&tienda->transacciones,
+                                                                vista + cab.offsetTransacciones,
+                                                                cab.numTransacciones, cab.version);
+        desmapearArchivo(vista, tam);
+    }
+
+    tienda->siguienteIdProducto = cab.siguienteIdProducto;
+    tienda->siguienteIdProveedor = cab.siguienteIdProveedor;
+    tienda->siguienteIdCliente = cab.siguienteIdCliente;
+    tienda->siguienteIdTransaccion = cab.siguienteIdTransaccion;
+
+    tienda->wal = nullptr;
+    tienda->lsn = cab.lsn;
+
+    iniciarIndicesTienda(tienda);
+
+    return cab.version;
+}
+
+//======================
+//3.2 recuperacin del registro de cambios
+//======================
+
+// Aplica un cambio ledo del WAL, con los registros en el formato de la
+// versin 'version'. Devuelve false si el payload no tiene el tamao que
+// corresponde a su tipo.
+bool aplicarCambio(Tienda* tienda, int tipo, const char* datos, unsigned int len, int version) {
+    switch (tipo) {
+
+    case CAMBIO_ALTA_PRODUCTO:
+    case CAMBIO_MODIFICA_PRODUCTO: {
+        if (len != tamEnVersion<Producto, ProductoV2, ProductoV3>(version)) return false;
+        Producto p;
+        leerEnVersion<Producto, ProductoV2, ProductoV3>(datos, version, &p);
+
+        int index = buscarProductoPorID(tienda, p.id);
+        if (index == -1)
+            agregarProducto(tienda, p);
+        else
+            reemplazarProducto(tienda, index, p);
+        return true;
+    }
+
+    case CAMBIO_STOCK_PRODUCTO: {
+        if (len != sizeof(CambioStock)) return false;
+        CambioStock cambio;
+        memcpy(&cambio, datos, sizeof(cambio));
+
+        int index = buscarProductoPorID(tienda, cambio.id);
+        if (index != -1)
+            fijarStockProducto(tienda, index, cambio.stock);
+        return true;
+    }
+
+    case CAMBIO_BAJA_PRODUCTO: {
+        if (len != sizeof(int)) return false;
+        int id;
+        memcpy(&id, datos, sizeof(id));
+
+        int index = buscarProductoPorID(tienda, id);
+        if (index != -1)
+            quitarProducto(tienda, index);
+        return true;
+    }
+
+    case CAMBIO_ALTA_PROVEEDOR:
+    case CAMBIO_MODIFICA_PROVEEDOR: {
+        if (len != tamEnVersion<Proveedor, ProveedorV2, Proveedor>(version)) return false;
+        Proveedor p;
+        leerEnVersion<Proveedor, ProveedorV2, Proveedor>(datos, version, &p);
+
+        int index = buscarProveedorPorID(tienda, p.id);
+        if (index == -1)
+            agregarProveedor(tienda, p);
+        else
+            reemplazarProveedor(tienda, index, p);
+        return true;
+    }
+
+    case CAMBIO_BAJA_PROVEEDOR: {
+        if (len != sizeof(int)) return false;
+        int id;
+        memcpy(&id, datos, sizeof(id));
+
+        int index = buscarProveedorPorID(tienda, id);
+        if (index != -1)
+            quitarProveedor(tienda, index);
+        return true;
+    }
+
+    case CAMBIO_ALTA_CLIENTE:
+    case CAMBIO_MODIFICA_CLIENTE: {
+        if (len != tamEnVersion<Cliente, ClienteV2, Cliente>(version)) return false;
+        Cliente c;
+        leerEnVersion<Cliente, ClienteV2, Cliente>(datos, version, &c);
+
+        int index = buscarClientePorID(tienda, c.id);
+        if (index == -1)
+            agregarCliente(tienda, c);
+        else
+            reemplazarCliente(tienda, index, c);
+        return true;
+    }
+
+    case CAMBIO_BAJA_CLIENTE: {
+        if (len != sizeof(int)) return false;
+        int id;
+        memcpy(&id, datos, sizeof(id));
+
+        int index = buscarClientePorID(tienda, id);
+        if (index != -1)
+            quitarCliente(tienda, index);
+        return true;
+    }
+
+    case CAMBIO_TRANSACCIONES: {
+        unsigned int tam = tamEnVersion<Transaccion, TransaccionV2, Transaccion>(version);
+        if (tam == 0 || len == 0 || len % tam != 0) return false;
+        int num = len / tam;
+        Transaccion* lineas = new Transaccion[num];
+        for (int i = 0; i < num; i++)
+            leerEnVersion<Transaccion, TransaccionV2, Transaccion>(datos + (size_t)i * tam, version, &lineas[i]);
+
+        asentarTransacciones(tienda, lineas, num);
+        delete[] lineas;
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+// Reaplica sobre el ltimo snapshot los cambios del WAL posteriores a l.
+// Un registro incompleto o con el CRC mal al final (corte de luz a mitad de
+// una escritura) marca el final del log y se recorta del archivo. Un registro
+// ntegro que no se puede aplicar no es un corte: se devuelve false sin tocar
+// el archivo, porque recortarlo perdera todo lo anotado despus.
+// 'version' es la del snapshot del que contina el log (la de sus registros).
+bool recuperarCambios(Tienda* tienda, const char* ruta, int version) {
+    FILE* f = fopen(ruta, "rb");
+    if (f == nullptr)
+        return true;
+
+    // El buffer crece con el registro ms grande ledo hasta ahora
+    unsigned int capacidad = 4096;
+    char* payload = new char[capacidad];
+
+    RegistroCambios* wal = tienda->wal;
+    tienda->wal = nullptr; // lo reaplicado no se vuelve a anotar
+
+    long long valido = 0;
+    int aplicados = 0;
+    bool corrupto = false;
+    bool ilegible = false;
+
+    CabeceraCambio cab;
+    while (fread(&cab, sizeof(cab), 1, f) == 1) {
+        if (cab.longitud > MAX_PAYLOAD_CAMBIO) {
+            corrupto = true;
+            break;
+        }
+        if (cab.longitud > capacidad) {
+            delete[] payload;
+            capacidad = max(cab.longitud, capacidad * 2);
+            payload = new char[capacidad];
+        }
+        if (fread(payload, 1, cab.longitud, f) != cab.longitud ||
+            cab.crc != crcCambio(cab, payload)) {
+            corrupto = true;
+            break;
+        }
+
+        if (cab.lsn > tienda->lsn) {
+            if (!aplicarCambio(tienda, cab.tipo, payload, cab.longitud, version)) {
+                ilegible = true;
+                break;
+            }
+            tienda->lsn = cab.lsn;
+            aplicados++;
+        }
+
+        valido += sizeof(cab) + cab.longitud;
+    }
+
+    if (!corrupto && !ilegible && !feof(f))
+        corrupto = true;
+    if (!corrupto && !ilegible) {
+        // fread pudo leer una cabecera a medias antes del EOF
+        corrupto = ftell(f) != valido;
+    }
+    fclose(f);
+    delete[] payload;
+
+    tienda->wal = wal;
+
+    if (ilegible) {
+        cerr << "ERROR: El cambio " << cab.lsn << " (tipo " << cab.tipo << ", " << cab.longitud
+             << " bytes) de " << ruta << " no se puede aplicar. No se modific el archivo.\n";
+        return false;
+    }
+    if (corrupto) {
+        truncarArchivo(ruta, valido);
+        cerr << "ADVERTENCIA: Se descart un cambio incompleto al final de " << ruta << ".\n";
+    }
+    if (aplicados > 0)
+        cerr << "Recuperados " << aplicados << " cambios desde " << ruta << ".\n";
+    return true;
+}
+
+// Carga el snapshot (o empieza vaca si no existe), reaplica el WAL y lo
+// deja abierto. Un snapshot de una versin anterior se convierte, se guarda
+// enseguida en la actual y su WAL se vaca, para que el log nunca mezcle
+// formatos. Si algo no se puede leer devuelve false sin tocar los archivos:
+// empezar vaca y guardar encima perdera los datos. Los avisos van a cerr:
+// en --comandos y --cadena la salida estndar es la de las respuestas.
+bool abrirTienda(Tienda* tienda, const char* rutaSnapshot, const char* rutaWal) {
+    int version = cargarSnapshot(tienda, rutaSnapshot);
+    if (version == -1)
+        return false;
+    if (version == 0) {
+        inicializarTienda(tienda, "", "");
+        version = VERSION_SNAPSHOT;
+    }
+
+    if (!recuperarCambios(tienda, rutaWal, version)) {
+        liberarTienda(tienda);
+        return false;
+    }
+
+    if (version != VERSION_SNAPSHOT) {
+        // Los registros viejos del WAL quedan dentro del snapshot; si el
+        // recorte no llega a hacerse, al releerlos se saltan por su lsn
+        if (!guardarSnapshot(tienda, rutaSnapshot)) {
+            liberarTienda(tienda);
+            return false;
+        }
+        truncarArchivo(rutaWal, 0);
+        cerr << "Se convirti " << rutaSnapshot << " de la versin " << version
+             << " a la " << VERSION_SNAPSHOT << ".\n";
+    }
+
+    tienda->wal = abrirRegistroCambios(rutaWal, tienda->lsn);
+    return true;
+}
+
+
+//======================
+//3.3 importacin masiva desde CSV
+//======================
+
+// El archivo se lee por bloques. Cada bloque se corta en trozos que parsean
+// y validan varios hilos a la vez; despus, en orden de archivo, un solo hilo
+// aplica las comprobaciones contra la tienda (duplicados, proveedor
+// existente) con tablas hash e ndices y guarda los registros. Las filas rechazadas se
+// escriben con su nmero de lnea y el motivo en <archivo>.rechazos.txt.
+//
+// Columnas (la primera lnea se ignora si es un encabezado):
+//   productos:   codigo,nombre,descripcion,idProveedor,precio,stock[,fecha[,stockMinimo]]
+//   proveedores: rif,nombre,email,telefono[,direccion]
+//   clientes:    cedula,nombre,email,telefono,direccion
+
+enum Entidad {
+    ENTIDAD_PRODUCTO,
+    ENTIDAD_PROVEEDOR,
+    ENTIDAD_CLIENTE
+};
+
+const int TAM_BLOQUE_CSV = 32 * 1024 * 1024;
+const int MAX_CAMPOS_CSV = 8;
+
+struct RechazoCsv {
+    long long linea;
+    char motivo[100];
+};
+
+struct ListaRechazos {
+    RechazoCsv* items;
+    int num;
+    int capacidad;
+};
+
+// Porcin de un bloque que parsea un hilo
+struct TrozoCsv {
+    char* inicio;
+    char* fin;
+    int entidad;
+
+    // Salida: solo se usa el array de la entidad que se importa
+    Producto* productos;
+    Proveedor* proveedores;
+    Cliente* clientes;
+    int* lineas;               // lnea (relativa al trozo) de cada registro
+    int numRegistros;
+    int numLineas;
+    ListaRechazos rechazos;    // lneas relativas al trozo
+};
+
+void agregarRechazo(ListaRechazos* lista, long long linea, const char* motivo) {
+    if (lista->num >= lista->capacidad) {
+        int nuevaCap = max(lista->capacidad * 2, 16);
+        RechazoCsv* nuevo = new RechazoCsv[nuevaCap];
+        for (int i = 0; i < lista->num; i++)
+            nuevo[i] = lista->items[i];
+        delete[] lista->items;
+        lista->items = nuevo;
+        lista->capacidad = nuevaCap;
+    }
+
+    lista->items[lista->num].linea = linea;
+    snprintf(lista->items[lista->num].motivo, sizeof(lista->items[0].motivo), "%s", motivo);
+    lista->num++;
+}
+
+// Separa una lnea CSV en campos, en el sitio. Admite campos entre comillas
+// con "" como comilla escapada. Devuelve el nmero de campos, o -1 si la
+// lnea est mal formada o tiene ms de maxCampos.
+int separarCamposCsv(char* linea, char** campos, int maxCampos) {
+    int n = 0;
+    char* p = linea;
+
+    while (true) {
+        if (n == maxCampos) return -1;
+
+        char* campo = p;
+        char* salida = p;
+
+        if (*p == '"') {
+            p++;
+            while (true) {
+                if (*p == '\0') return -1;
+                if (*p == '"') {
+                    if (p[1] == '"') {
+                        *salida++ = '"';
+                        p += 2;
+                        continue;
+                    }
+                    p++;
+                    break;
+                }
+                *salida++ = *p++;
+            }
+            if (*p != ',' && *p != '\0') return -1;
+        } else {
+            while (*p != ',' && *p != '\0') p++;
+            salida = p;
+        }
+
+        char separador = *p;
+        *salida = '\0';
+        campos[n++] = campo;
+
+        if (separador == '\0') return n;
+        p++;
+    }
+}
+
+bool copiarCampoCsv(char* destino, int tam, const char* valor, const char* nombre,
+                    char* motivo, bool obligatorio = true) {
+    int len = strlen(valor);
+    if (obligatorio && len == 0) {
+        snprintf(motivo, 100, "El campo %s no puede estar vaco", nombre);
+        return false;
+    }
+    if (len >= tam) {
+        snprintf(motivo, 100, "El campo %s excede %d caracteres", nombre, tam - 1);
+        return false;
+    }
+    memcpy(destino, valor, len + 1);
+    return true;
+}
+
+bool leerEnteroCsv(const char* valor, int* destino) {
+    char* fin;
+    long v = strtol(valor, &fin, 10);
+    if (fin == valor || *fin != '\0' || v < INT_MIN || v > INT_MAX) return false;
+    *destino = (int)v;
+    return true;
+}
+
+bool leerDecimalCsv(const char* valor, float* destino) {
+    char* fin;
+    double v = strtod(valor, &fin);
+    if (fin == valor || *fin != '\0') return false;
+    *destino = (float)v;
+    return true;
+}
+
+// Mismas reglas que crearProducto, salvo las que dependen de la tienda
+bool parsearProductoCsv(char** campos, int n, int hoy, Producto* p, char* motivo) {
+    if (n < 6 || n > 8) {
+        snprintf(motivo, 100, "Se esperaban de 6 a 8 campos y hay %d", n);
+        return false;
+    }
+
+    memset(p, 0, sizeof(*p));
+    if (!copiarCampoCsv(p->codigo, sizeof(p->codigo), campos[0], "codigo", motivo) ||
+        !copiarCampoCsv(p->nombre, sizeof(p->nombre), campos[1], "nombre", motivo) ||
+        !copiarCampoCsv(p->descripcion, sizeof(p->descripcion), campos[2], "descripcion", motivo))
+        return false;
+
+    if (!sinEspacios(p->codigo)) {
+        snprintf(motivo, 100, "El cdigo no puede contener espacios");
+        return false;
+    }
+    if (!leerEnteroCsv(campos[3], &p->idProveedor) || p->idProveedor <= 0) {
+        snprintf(motivo, 100, "idProveedor invlido: '%.40s'", campos[3]);
+        return false;
+    }
+    if (!leerDecimalCsv(campos[4], &p->precio) || !(p->precio > 0)) {
+        snprintf(motivo, 100, "Precio invlido (debe ser > 0): '%.40s'", campos[4]);
+        return false;
+    }
+    if (!leerEnteroCsv(campos[5], &p->stock) || p->stock < 0) {
+        snprintf(motivo, 100, "Stock invlido (debe ser >= 0): '%.40s'", campos[5]);
+        return false;
+    }
+
+    if (n >= 7 && campos[6][0] != '\0') {
+        if (!parsearFecha(campos[6], &p->fechaRegistro)) {
+            snprintf(motivo, 100, "Fecha invlida (YYYY-MM-DD): '%.40s'", campos[6]);
+            return false;
+        }
+    } else {
+        p->fechaRegistro = hoy;
+    }
+
+    p->stockMinimo = 0;
+    if (n == 8 && campos[7][0] != '\0' && (!leerEnteroCsv(campos[7], &p->stockMinimo) || p->stockMinimo < 0)) {
+        snprintf(motivo, 100, "Stock mnimo invlido (debe ser >= 0): '%.40s'", campos[7]);
+        return false;
+    }
+
+    p->id = 0;
+    return true;
+}
+
+bool parsearProveedorCsv(char** campos, int n, int hoy, Proveedor* p, char* motivo) {
+    if (n != 4 && n != 5) {
+        snprintf(motivo, 100, "Se esperaban 4 o 5 campos y hay %d", n);
+        return false;
+    }
+
+    memset(p, 0, sizeof(*p));
+    if (!copiarCampoCsv(p->rif, sizeof(p->rif), campos[0], "rif", motivo) ||
+        !copiarCampoCsv(p->nombre, sizeof(p->nombre), campos[1], "nombre", motivo) ||
+        !copiarCampoCsv(p->email, sizeof(p->email), campos[2], "email", motivo) ||
+        !copiarCampoCsv(p->telefono, sizeof(p->telefono), campos[3], "telefono", motivo) ||
+        (n == 5 && !copiarCampoCsv(p->direccion, sizeof(p->direccion), campos[4],
+                                   "direccion", motivo, false)))
+        return false;
+
+    if (!emailValido(p->email)) {
+        snprintf(motivo, 100, "El email debe contener '@' y un punto");
+        return false;
+    }
+
+    p->fechaRegistro = hoy;
+    return true;
+}
+
+bool parsearClienteCsv(char** campos, int n, int hoy, Cliente* c, char* motivo) {
+    if (n != 5) {
+        snprintf(motivo, 100, "Se esperaban 5 campos y hay %d", n);
+        return false;
+    }
+
+    memset(c, 0, sizeof(*c));
+    if (!copiarCampoCsv(c->cedula, sizeof(c->cedula), campos[0], "cedula", motivo) ||
+        !copiarCampoCsv(c->nombre, sizeof(c->nombre), campos[1], "nombre", motivo) ||
+        !copiarCampoCsv(c->email, sizeof(c->email), campos[2], "email", motivo) ||
+        !copiarCampoCsv(c->telefono, sizeof(c->telefono), campos[3], "telefono", motivo) ||
+        !copiarCampoCsv(c->direccion, sizeof(c->direccion), campos[4], "direccion", motivo))
+        return false;
+
+    if (!emailValido(c->email)) {
+        snprintf(motivo, 100, "El email debe contener '@' y un punto");
+        return false;
+    }
+
+    c->id = 0;
+    c->fechaRegistro = hoy;
+    return true;
+}
+
+// Trabajo de cada hilo: parsea y valida las lneas de su trozo
+void parsearTrozoCsv(TrozoCsv* trozo, int hoy) {
+    // Cota superior de registros: una lnea por '\n' ms una posible final
+    int maxLineas = 1;
+    for (const char* c = trozo->inicio; c < trozo->fin; c++)
+        if (*c == '\n') maxLineas++;
+
+    if (trozo->entidad == ENTIDAD_PRODUCTO)
+        trozo->productos = new Producto[maxLineas];
+    else if (trozo->entidad == ENTIDAD_PROVEEDOR)
+        trozo->proveedores = new Proveedor[maxLineas];
+    else
+        trozo->clientes = new Cliente[maxLineas];
+    trozo->lineas = new int[maxLineas];
+
+    char* campos[MAX_CAMPOS_CSV];
+    char motivo[100];
+    char* linea = trozo->inicio;
+
+    while (linea < trozo->fin) {
+        char* finLinea = (char*)memchr(linea, '\n', trozo->fin - linea);
+        char* siguiente;
+        if (finLinea == nullptr) {
+            finLinea = trozo->fin;
+            siguiente = trozo->fin;
+        } else {
+            siguiente = finLinea + 1;
+        }
+        if (finLinea > linea && finLinea[-1] == '\r')
+            finLinea--;
+        *finLinea = '\0';
+
+        int numLinea = trozo->numLineas++;
+        if (linea[0] != '\0') {
+            int n = separarCamposCsv(linea, campos, MAX_CAMPOS_CSV);
+            int k = trozo->numRegistros;
+            bool ok;
+
+            if (n < 0) {
+                snprintf(motivo, sizeof(motivo), "Lnea CSV mal formada");
+                ok = false;
+            } else if (trozo->entidad == ENTIDAD_PRODUCTO) {
+                ok = parsearProductoCsv(campos, n, hoy, &trozo->productos[k], motivo);
+            } else if (trozo->entidad == ENTIDAD_PROVEEDOR) {
+                ok = parsearProveedorCsv(campos, n, hoy, &trozo->proveedores[k], motivo);
+            } else {
+                ok = parsearClienteCsv(campos, n, hoy, &trozo->clientes[k], motivo);
+            }
+
+            if (ok) {
+                trozo->lineas[k] = numLinea;
+                trozo->numRegistros++;
+            } else {
+                agregarRechazo(&trozo->rechazos, numLinea, motivo);
+            }
+        }
+
+        linea = siguiente;
+    }
+}
+
+void liberarTrozoCsv(TrozoCsv* trozo) {
+    delete[] trozo->productos;
+    delete[] trozo->proveedores;
+    delete[] trozo->clientes;
+    delete[] trozo->lineas;
+    delete[] trozo->rechazos.items;
+}
+
+// Estado de una importacin que dura entre bloques
+struct ImportacionCsv {
+    int entidad;
+    int importados;
+    ListaRechazos rechazos;    // lneas absolutas del archivo
+};
+
+// Aplica en orden los registros que pasaron el parseo
+// Altas ya parseadas: comprueban lo que depende de la tienda (proveedor
+// existente, claves nicas), asignan el id y agregan. Tambin las usa el modo
+// por lotes.
+bool altaProducto(Tienda* tienda, Producto* p, char* motivo) {
+    if (!existeProveedor(tienda, p->idProveedor)) {
+        snprintf(motivo, 100, "El proveedor con ID %d no existe", p->idProveedor);
+        return false;
+    }
+    if (codigoProductoDuplicado(tienda, p->codigo)) {
+        snprintf(motivo, 100, "El cdigo '%s' ya est registrado", p->codigo);
+        return false;
+    }
+
+    p->id = tienda->siguienteIdProducto++;
+    agregarProducto(tienda, *p);
+    return true;
+}
+
+bool altaProveedor(Tienda* tienda, Proveedor* p, char* motivo) {
+    if (rifDuplicado(tienda, p->rif)) {
+        snprintf(motivo, 100, "El RIF '%s' ya est registrado", p->rif);
+        return false;
+    }
+
+    p->id = tienda->siguienteIdProveedor++;
+    agregarProveedor(tienda, *p);
+    return true;
+}
+
+bool altaCliente(Tienda* tienda, Cliente* c, char* motivo) {
+    if (clienteDuplicado(tienda, c->cedula)) {
+        snprintf(motivo, 100, "La cdula/RIF '%s' ya est registrada", c->cedula);
+        return false;
+    }
+
+    c->id = tienda->siguienteIdCliente++;
+    agregarCliente(tienda, *c);
+    return true;
+}
+
+void aplicarTrozoCsv(Tienda* tienda, ImportacionCsv* imp, TrozoCsv* trozo, long long lineaBase) {
+    char motivo[100];
+
+    for (int k = 0; k < trozo->numRegistros; k++) {
+        long long linea = lineaBase + trozo->lineas[k];
+
+        bool ok;
+        if (imp->entidad == ENTIDAD_PRODUCTO)
+            ok = altaProducto(tienda, &trozo->productos[k], motivo);
+        else if (imp->entidad == ENTIDAD_PROVEEDOR)
+            ok = altaProveedor(tienda, &trozo->proveedores[k], motivo);
+        else
+            ok = altaCliente(tienda, &trozo->clientes[k], motivo);
+
+        if (ok)
+            imp->importados++;
+        else
+            agregarRechazo(&imp->rechazos, linea, motivo);
+    }
+}
+
+bool esEncabezadoCsv(const char* linea, int entidad) {
+    const char* esperado = entidad == ENTIDAD_PRODUCTO ? "codigo"
+                         : entidad == ENTIDAD_PROVEEDOR ? "rif" : "cedula";
+    int len = strlen(esperado);
+    for (int i = 0; i < len; i++)
+        if (tolower((unsigned char)linea[i]) != esperado[i])
+            return false;
+    return linea[len] == ',' || linea[len] == ';';
+}
+
+bool compararRechazos(const RechazoCsv& a, const RechazoCsv& b) {
+    return a.linea < b.linea;
+}
+
+// Procesa un bloque de lneas completas que empieza en la lnea 'lineaBase'.
+// Devuelve el nmero de lneas que contena.
+long long procesarBloqueCsv(Tienda* tienda, ImportacionCsv* imp, char* bloque, long long len,
+                            long long lineaBase, int numHilos, int hoy) {
+    TrozoCsv* trozos = new TrozoCsv[numHilos];
+    memset(trozos, 0, numHilos * sizeof(TrozoCsv));
+
+    // Cortar en trozos de tamao parecido, siempre al final de una lnea
+    char* inicio = bloque;
+    char* finBloque = bloque + len;
+    for (int t = 0; t < numHilos; t++) {
+        char* fin = t == numHilos - 1 ? finBloque : inicio + (finBloque - inicio) / (numHilos - t);
+        if (fin < finBloque) {
+            char* nl = (char*)memchr(fin, '\n', finBloque - fin);
+            fin = nl == nullptr ? finBloque : nl + 1;
+        }
+        trozos[t].inicio = inicio;
+        trozos[t].fin = fin;
+        trozos[t].entidad = imp->entidad;
+        inicio = fin;
+    }
+
+    thread* hilos = new thread[numHilos];
+    for (int t = 0; t < numHilos; t++)
+        hilos[t] = thread(parsearTrozoCsv, &trozos[t], hoy);
+    for (int t = 0; t < numHilos; t++)
+        hilos[t].join();
+    delete[] hilos;
+
+    int totalRegistros = 0;
+    for (int t = 0; t < numHilos; t++)
+        totalRegistros += trozos[t].numRegistros;
+
+    if (imp->entidad == ENTIDAD_PRODUCTO)
+        reservarTabla(&tienda->productos, tienda->productos.num + totalRegistros);
+    else if (imp->entidad == ENTIDAD_PROVEEDOR)
+        reservarTabla(&tienda->proveedores, tienda->proveedores.num + totalRegistros);
+    else
+        reservarTabla(&tienda->clientes, tienda->clientes.num + totalRegistros);
+
+    long long linea = lineaBase;
+    for (int t = 0; t < numHilos; t++) {
+        for (int r = 0; r < trozos[t].rechazos.num; r++)
+            agregarRechazo(&imp->rechazos, linea + trozos[t].rechazos.items[r].linea,
+                           trozos[t].rechazos.items[r].motivo);
+
+        aplicarTrozoCsv(tienda, imp, &trozos[t], linea);
+        linea += trozos[t].numLineas;
+        liberarTrozoCsv(&trozos[t]);
+    }
+
+    delete[] trozos;
+    return linea - lineaBase;
+}
+
+bool importarCsv(Tienda* tienda, int entidad, const char* ruta) {
+    FILE* f = fopen(ruta, "rb");
+    if (f == nullptr) {
+        cout << "ERROR: No se pudo abrir " << ruta << ".\n";
+        return false;
+    }
+
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+
+    ImportacionCsv imp;
+    imp.entidad = entidad;
+    imp.importados = 0;
+    imp.rechazos.items = nullptr;
+    imp.rechazos.num = 0;
+    imp.rechazos.capacidad = 0;
+
+    int numHilos = thread::hardware_concurrency();
+    if (numHilos < 1) numHilos = 1;
+    if (numHilos > 16) numHilos = 16;
+
+    // Las filas importadas no pasan por el WAL: al terminar se guarda un
+    // snapshot, que es mucho ms barato que anotar millones de registros
+    RegistroCambios* wal = tienda->wal;
+    tienda->wal = nullptr;
+
+    char* bloque = new char[TAM_BLOQUE_CSV + 1];
+    long long arrastre = 0;    // lnea incompleta del bloque anterior
+    long long lineaBase = 1;
+    bool primerBloque = true;
+    bool ok = true;
+
+    while (true) {
+        size_t pedidos = TAM_BLOQUE_CSV - arrastre;
+        size_t leidos = fread(bloque + arrastre, 1, pedidos, f);
+        bool finArchivo = leidos < pedidos;
+        long long len = arrastre + leidos;
+        if (len == 0) break;
+
+        // Cortar tras el ltimo salto de lnea; el resto pasa al siguiente bloque
+        long long corte = len;
+        if (!finArchivo) {
+            while (corte > 0 && bloque[corte - 1] != '\n') corte--;
+            if (corte == 0) {
+                cout << "ERROR: La lnea " << lineaBase << " es demasiado larga.\n";
+                ok = false;
+                break;
+            }
+        }
+
+        char saltado = bloque[corte];
+        bloque[corte] = '\0';
+
+        char* inicio = bloque;
+        if (primerBloque) {
+            if (esEncabezadoCsv(bloque, entidad)) {
+                char* nl = strchr(bloque, '\n');
+                inicio = nl == nullptr ? bloque + corte : nl + 1;
+                lineaBase++;
+            }
+            primerBloque = false;
+        }
+
+        // La fecha por omisin es la del da en que se procesa cada bloque
+        lineaBase += procesarBloqueCsv(tienda, &imp, inicio, bloque + corte - inicio,
+                                       lineaBase, numHilos, fechaActual());
+
+        bloque[corte] = saltado;
+        arrastre = len - corte;
+        memmove(bloque, bloque + corte, (size_t)arrastre);
+
+        if (finArchivo) break;
+    }
+
+    delete[] bloque;
+    fclose(f);
+    tienda->wal = wal;
+
+    // Reporte de rechazos, ordenado por lnea
+    sort(imp.rechazos.items, imp.rechazos.items + imp.rechazos.num, compararRechazos);
+
+    char rutaReporte[300];
+    snprintf(rutaReporte, sizeof(rutaReporte), "%s.rechazos.txt", ruta);
+    FILE* reporte = fopen(rutaReporte, "w");
+    if (reporte != nullptr) {
+        fprintf(reporte, "linea;motivo\n");
+        for (int i = 0; i < imp.rechazos.num; i++)
+            fprintf(reporte, "%lld;%s\n", imp.rechazos.items[i].linea, imp.rechazos.items[i].motivo);
+        fclose(reporte);
+    }
+
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    cout << "\n=== IMPORTACIN CSV ===\n";
+    cout << "Importados: " << imp.importados << endl;
+    cout << "Rechazados: " << imp.rechazos.num;
+    if (imp.rechazos.num > 0)
+        cout << " (ver " << rutaReporte << ")";
+    cout << endl;
+    cout << "Tiempo: " << fixed << setprecision(2) << segundos << " s\n";
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+
+    delete[] imp.rechazos.items;
+
+    if (imp.importados > 0 && !guardarSnapshot(tienda, ARCHIVO_SNAPSHOT))
+        ok = false;
+
+    return ok;
+}
+
+void menuImportarCsv(Tienda* tienda) {
+    int opcion;
+    cout << "\n=== IMPORTAR CSV ===\n";
+    cout << "1. Productos\n";
+    cout << "2. Proveedores\n";
+    cout << "3. Clientes\n";
+    cout << "0. Cancelar\n";
+    cout << "Seleccione una opcin: ";
+    cin >> opcion;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    if (opcion < 1 || opcion > 3)
         return;
 
-    // --- Telfono ---
-    solicitarString("Ingrese telfono del proveedor (o CANCELAR): ",
-                    nuevo.telefono, 20);
+    char ruta[260];
+    solicitarString("Ruta del archivo CSV: ", ruta, 260);
 
-    if (strcmp(nuevo.telefono, "CANCELAR") == 0 || strcmp(nuevo.telefono, "0") == 0)
+    int entidad = opcion == 1 ? ENTIDAD_PRODUCTO
+                : opcion == 2 ? ENTIDAD_PROVEEDOR : ENTIDAD_CLIENTE;
+    importarCsv(tienda, entidad, ruta);
+}
+
+// Escribe la tabla completa de una entidad en un archivo de texto
+void exportarListado(Tienda* tienda) {
+    int opcion;
+    cout << "\n=== EXPORTAR LISTADO ===\n";
+    cout << "1. Productos\n";
+    cout << "2. Proveedores\n";
+    cout << "3. Clientes\n";
+    cout << "0. Cancelar\n";
+    cout << "Seleccione una opcin: ";
+    cin >> opcion;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    if (opcion < 1 || opcion > 3)
         return;
 
-    // --- Confirmacin ---
-    cout << "\n=== RESUMEN DEL PROVEEDOR ===\n";
-    cout << "RIF: " << nuevo.rif << endl;
-    cout << "Nombre: " << nuevo.nombre << endl;
-    cout << "Email: " << nuevo.email << endl;
-    cout << "Telfono: " << nuevo.telefono << endl;
+    char ruta[260];
+    solicitarString("Ruta del archivo de salida: ", ruta, 260);
 
-    if (!confirmar("Guardar proveedor? (S/N): "))
+    FILE* f = fopen(ruta, "wb");
+    if (f == nullptr) {
+        cout << "ERROR: No se pudo crear " << ruta << ".\n";
         return;
+    }
+
+    int filas;
+    bool ok;
+    if (opcion == 1) {
+        filas = activosEnTabla(tienda->productos);
+        ok = tablaProductos(tienda, f, 0, -1);
+    } else if (opcion == 2) {
+        filas = activosEnTabla(tienda->proveedores);
+        ok = tablaProveedores(tienda, f, 0, -1);
+    } else {
+        filas = activosEnTabla(tienda->clientes);
+        ok = tablaClientes(tienda, f, 0, -1);
+    }
+    if (fclose(f) != 0) ok = false;
 
-    // --- Redimensionar si es necesario ---
-    if (tienda->numProveedores >= tienda->capacidadProveedores)
-        redimensionarProveedores(tienda);
+    if (ok)
+        cout << filas << " registros exportados a " << ruta << ".\n";
+    else
+        cout << "ERROR: Fall la escritura de " << ruta << ".\n";
+}
 
-    // --- Guardar ---
-    nuevo.id = tienda->siguienteIdProveedor++;
-    tienda->proveedores[tienda->numProveedores++] = nuevo;
 
-    cout << "Proveedor registrado exitosamente.\n";
+//main temporal
+
+//======================
+//3.4 modo por lotes
+//======================
+
+// inventario --comandos [archivo]
+//
+// Lee una operacin por lnea (de 'archivo' o de la entrada estndar), sin
+// mens, confirmaciones ni pausas. Los campos van separados por comas, con
+// las mismas reglas de comillas que la importacin CSV:
+//
+//   crear,producto,codigo,nombre,descripcion,idProveedor,precio,stock[,fecha[,stockMinimo]]
+//   crear,proveedor,rif,nombre,email,telefono[,direccion]
+//   crear,cliente,cedula,nombre,email,telefono,direccion
+//   buscar,producto,id|codigo|nombre,valor
+//   buscar,producto,fecha,desde[,hasta]
+//   buscar,proveedor,id|rif|nombre,valor
+//   buscar,cliente,id|cedula|nombre,valor
+//   stock,idProducto,ajuste
+//   minimo,idProducto,stockMinimo
+//   reponer[,n[,idProveedor]]
+//   eliminar,producto|proveedor|cliente,id
+//   listar,productos|proveedores|clientes[,desde,limite[,campo[,asc|desc]]]
+//     (campo: registro o nombre; en productos tambin precio, stock o fecha)
+//   compra,idProveedor,idProducto,cantidad[,idProducto,cantidad...]
+//   venta,idCliente,idProducto,cantidad[,idProducto,cantidad...]
+//   resumen[,idProveedor]
+//   reporte,dias|proveedores,desde,hasta
+//   reporte,productos,desde,hasta[,n[,unidades|ingresos]]
+//   guardar
+//
+// Las lneas vacas y las que empiezan con '#' se ignoran. Cada operacin
+// responde "OK ..." (las bsquedas y listados escriben antes un registro por
+// lnea en CSV) o "ERROR <lnea>: <motivo>". Los cambios van al WAL sin
+// esperar el fsync de cada uno; se espera una sola vez al final y en cada
+// 'guardar'.
+
+const int MAX_LINEA_COMANDO = 4096;
+const int MAX_CAMPOS_COMANDO = 64;
+
+void escribirCampoCsv(ostream& salida, const char* valor) {
+    if (strpbrk(valor, ",\"\n\r") == nullptr) {
+        salida << valor;
+        return;
+    }
+
+    salida << '"';
+    for (const char* c = valor; *c != '\0'; c++) {
+        if (*c == '"') salida << '"';
+        salida << *c;
+    }
+    salida << '"';
 }
 
-//2.3.2
+void escribirFechaCsv(ostream& salida, int dias) {
+    char fecha[LARGO_FECHA];
+    formatearFecha(dias, fecha);
+    salida << fecha;
+}
 
-void buscarProveedor(Tienda* tienda) {
-    int opcion;
+// Un monto en centavos, con dos decimales
+void escribirCentavosCsv(ostream& salida, long long centavos) {
+    unsigned long long magnitud = centavos < 0 ? 0ULL - (unsigned long long)centavos : centavos;
+    salida << (centavos < 0 ? "-" : "") << magnitud / 100 << '.'
+           << (char)('0' + magnitud / 10 % 10) << (char)('0' + magnitud % 10);
+}
 
-    do {
-        cout << "\n=== BUSCAR PROVEEDOR ===\n";
-        cout << "1. Buscar por ID\n";
-        cout << "2. Buscar por nombre (coincidencia parcial)\n";
-        cout << "3. Buscar por RIF\n";
-        cout << "0. Cancelar\n";
-        cout << "Seleccione una opcin: ";
-        cin >> opcion;
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+void escribirProductoCsv(ostream& salida, const Producto& p) {
+    salida << p.id << ',';
+    escribirCampoCsv(salida, p.codigo);
+    salida << ',';
+    escribirCampoCsv(salida, p.nombre);
+    salida << ',';
+    escribirCampoCsv(salida, p.descripcion);
+    salida << ',' << p.idProveedor << ',' << fixed << setprecision(2) << p.precio
+           << ',' << p.stock << ',';
+    escribirFechaCsv(salida, p.fechaRegistro);
+    salida << ',' << p.stockMinimo << '\n';
+}
 
-        if (opcion == 0)
-            return;
+void escribirProveedorCsv(ostream& salida, const Proveedor& p) {
+    salida << p.id << ',';
+    escribirCampoCsv(salida, p.rif);
+    salida << ',';
+    escribirCampoCsv(salida, p.nombre);
+    salida << ',';
+    escribirCampoCsv(salida, p.email);
+    salida << ',';
+    escribirCampoCsv(salida, p.telefono);
+    salida << ',';
+    escribirCampoCsv(salida, p.direccion);
+    salida << ',';
+    escribirFechaCsv(salida, p.fechaRegistro);
+    salida << '\n';
+}
+
+void escribirClienteCsv(ostream& salida, const Cliente& c) {
+    salida << c.id << ',';
+    escribirCampoCsv(salida, c.cedula);
+    salida << ',';
+    escribirCampoCsv(salida, c.nombre);
+    salida << ',';
+    escribirCampoCsv(salida, c.email);
+    salida << ',';
+    escribirCampoCsv(salida, c.telefono);
+    salida << ',';
+    escribirCampoCsv(salida, c.direccion);
+    salida << ',';
+    escribirFechaCsv(salida, c.fechaRegistro);
+    salida << '\n';
+}
+
+// "producto"/"productos" -> ENTIDAD_PRODUCTO, etc.; -1 si no se reconoce
+int entidadPorNombre(const char* nombre) {
+    if (strcmp(nombre, "producto") == 0 || strcmp(nombre, "productos") == 0)
+        return ENTIDAD_PRODUCTO;
+    if (strcmp(nombre, "proveedor") == 0 || strcmp(nombre, "proveedores") == 0)
+        return ENTIDAD_PROVEEDOR;
+    if (strcmp(nombre, "cliente") == 0 || strcmp(nombre, "clientes") == 0)
+        return ENTIDAD_CLIENTE;
+    return -1;
+}
+
+// CampoOrden de un listado; precio, stock y fecha son solo de productos
+int campoOrdenPorNombre(const char* nombre, int entidad) {
+    if (strcmp(nombre, "registro") == 0) return ORDEN_REGISTRO;
+    if (strcmp(nombre, "nombre") == 0) return ORDEN_NOMBRE;
+    if (entidad != ENTIDAD_PRODUCTO) return -1;
+    if (strcmp(nombre, "precio") == 0) return ORDEN_PRECIO;
+    if (strcmp(nombre, "stock") == 0) return ORDEN_STOCK;
+    if (strcmp(nombre, "fecha") == 0) return ORDEN_FECHA;
+    return -1;
+}
+
+bool comandoCrear(Tienda* tienda, ostream& salida, char** campos, int n, int hoy, char* motivo) {
+    int entidad = entidadPorNombre(campos[1]);
+    char** datos = campos + 2;
+    int numDatos = n - 2;
+
+    if (entidad == ENTIDAD_PRODUCTO) {
+        Producto p;
+        memset(&p, 0, sizeof(p));
+        if (!parsearProductoCsv(datos, numDatos, hoy, &p, motivo) || !altaProducto(tienda, &p, motivo))
+            return false;
+        salida << "OK " << p.id << '\n';
+    } else if (entidad == ENTIDAD_PROVEEDOR) {
+        Proveedor p;
+        if (!parsearProveedorCsv(datos, numDatos, hoy, &p, motivo) || !altaProveedor(tienda, &p, motivo))
+            return false;
+        salida << "OK " << p.id << '\n';
+    } else if (entidad == ENTIDAD_CLIENTE) {
+        Cliente c;
+        if (!parsearClienteCsv(datos, numDatos, hoy, &c, motivo) || !altaCliente(tienda, &c, motivo))
+            return false;
+        salida << "OK " << c.id << '\n';
+    } else {
+        snprintf(motivo, 100, "Entidad desconocida '%.40s'", campos[1]);
+        return false;
+    }
+    return true;
+}
+
+bool comandoBuscar(Tienda* tienda, ostream& salida, char** campos, int n, char* motivo) {
+    bool rango = n == 5 && strcmp(campos[2], "fecha") == 0;
+    if (n != 4 && !rango) {
+        snprintf(motivo, 100, "Uso: buscar,<entidad>,<campo>,<valor>");
+        return false;
+    }
+
+    int entidad = entidadPorNombre(campos[1]);
+    const char* campo = campos[2];
+    const char* valor = campos[3];
+    int encontrados = 0;
+
+    if (entidad == ENTIDAD_PRODUCTO) {
+        if (strcmp(campo, "nombre") == 0) {
+            int* resultados = buscarProductosPorNombre(tienda, valor, &encontrados);
+            for (int i = 0; i < encontrados; i++)
+                escribirProductoCsv(salida, tienda->productos[resultados[i]]);
+            delete[] resultados;
+        } else if (strcmp(campo, "fecha") == 0) {
+            int desde, hasta;
+            if (!parsearFecha(valor, &desde) || !parsearFecha(rango ? campos[4] : valor, &hasta)) {
+                snprintf(motivo, 100, "Uso: buscar,producto,fecha,YYYY-MM-DD[,YYYY-MM-DD]");
+                return false;
+            }
+            int* resultados = productosRegistradosEntre(tienda, desde, hasta, &encontrados);
+            for (int i = 0; i < encontrados; i++)
+                escribirProductoCsv(salida, tienda->productos[resultados[i]]);
+            delete[] resultados;
+        } else {
+            int index = -1;
+            if (strcmp(campo, "id") == 0)
+                index = buscarProductoPorID(tienda, atoi(valor));
+            else if (strcmp(campo, "codigo") == 0)
+                index = buscarProductoPorID(tienda, idPorCodigo(tienda, valor));
+            else {
+                snprintf(motivo, 100, "Campo de bsqueda desconocido '%.40s'", campo);
+                return false;
+            }
+            if (index != -1) {
+                escribirProductoCsv(salida, tienda->productos[index]);
+                encontrados = 1;
+            }
+        }
+    } else if (entidad == ENTIDAD_PROVEEDOR) {
+        int index;
+        if (strcmp(campo, "id") == 0) index = buscarProveedorPorID(tienda, atoi(valor));
+        else if (strcmp(campo, "rif") == 0) index = buscarProveedorPorRIF(tienda, valor);
+        else if (strcmp(campo, "nombre") == 0) index = buscarProveedorPorNombre(tienda, valor);
+        else {
+            snprintf(motivo, 100, "Campo de bsqueda desconocido '%.40s'", campo);
+            return false;
+        }
+        if (index != -1) {
+            escribirProveedorCsv(salida, tienda->proveedores[index]);
+            encontrados = 1;
+        }
+    } else if (entidad == ENTIDAD_CLIENTE) {
+        int index;
+        if (strcmp(campo, "id") == 0) index = buscarClientePorID(tienda, atoi(valor));
+        else if (strcmp(campo, "cedula") == 0) index = buscarClientePorCedula(tienda, valor);
+        else if (strcmp(campo, "nombre") == 0) index = buscarClientePorNombre(tienda, valor);
+        else {
+            snprintf(motivo, 100, "Campo de bsqueda desconocido '%.40s'", campo);
+            return false;
+        }
+        if (index != -1) {
+            escribirClienteCsv(salida, tienda->clientes[index]);
+            encontrados = 1;
+        }
+    } else {
+        snprintf(motivo, 100, "Entidad desconocida '%.40s'", campos[1]);
+        return false;
+    }
+
+    salida << "OK " << encontrados << '\n';
+    return true;
+}
+
+bool comandoStock(Tienda* tienda, ostream& salida, char** campos, int n, char* motivo) {
+    int id, ajuste;
+    if (n != 3 || !leerEnteroCsv(campos[1], &id) || !leerEnteroCsv(campos[2], &ajuste)) {
+        snprintf(motivo, 100, "Uso: stock,<idProducto>,<ajuste>");
+        return false;
+    }
+
+    int index = buscarProductoPorID(tienda, id);
+    if (index == -1) {
+        snprintf(motivo, 100, "No existe un producto con ID %d", id);
+        return false;
+    }
+
+    long long nuevoStock = (long long)tienda->productos[index].stock + ajuste;
+    if (nuevoStock < 0) {
+        snprintf(motivo, 100, "Stock insuficiente. Disponible: %d, Solicitado: %d",
+                 tienda->productos[index].stock, -ajuste);
+        return false;
+    }
+    if (nuevoStock > INT_MAX) {
+        snprintf(motivo, 100, "El stock se desborda: %d + %d supera el mximo de %d",
+                 tienda->productos[index].stock, ajuste, INT_MAX);
+        return false;
+    }
+
+    fijarStockProducto(tienda, index, (int)nuevoStock);
+    salida << "OK " << nuevoStock << '\n';
+    return true;
+}
+
+bool comandoMinimo(Tienda* tienda, ostream& salida, char** campos, int n, char* motivo) {
+    int id, minimo;
+    if (n != 3 || !leerEnteroCsv(campos[1], &id) || !leerEnteroCsv(campos[2], &minimo) || minimo < 0) {
+        snprintf(motivo, 100, "Uso: minimo,<idProducto>,<stockMinimo >= 0>");
+        return false;
+    }
+
+    int index = buscarProductoPorID(tienda, id);
+    if (index == -1) {
+        snprintf(motivo, 100, "No existe un producto con ID %d", id);
+        return false;
+    }
+
+    Producto p = tienda->productos[index];
+    p.stockMinimo = minimo;
+    reemplazarProducto(tienda, index, p);
+    salida << "OK " << minimo << '\n';
+    return true;
+}
+
+// Los n productos ms urgentes por debajo de su mnimo (todos si no hay n),
+// agrupados por proveedor: idProveedor,idProducto,codigo,stock,stockMinimo,faltan
+bool comandoReponer(Tienda* tienda, ostream& salida, char** campos, int n, char* motivo) {
+    int k = 0, idProveedor = 0;
+    if (n > 3 || (n >= 2 && (!leerEnteroCsv(campos[1], &k) || k < 0)) ||
+        (n == 3 && (!leerEnteroCsv(campos[2], &idProveedor) || !existeProveedor(tienda, idProveedor)))) {
+        snprintf(motivo, 100, "Uso: reponer[,n[,idProveedor existente]]");
+        return false;
+    }
+
+    int num;
+    int* posiciones = productosPorReponer(tienda, k, idProveedor, &num);
+    for (int i = 0; i < num; i++) {
+        const Producto& p = tienda->productos[posiciones[i]];
+        salida << p.idProveedor << ',' << p.id << ',';
+        escribirCampoCsv(salida, p.codigo);
+        salida << ',' << p.stock << ',' << p.stockMinimo << ',' << p.stockMinimo - p.stock << '\n';
+    }
+    delete[] posiciones;
+    salida << "OK " << num << '\n';
+    return true;
+}
+
+bool comandoEliminar(Tienda* tienda, ostream& salida, char** campos, int n, char* motivo) {
+    int id;
+    if (n != 3 || !leerEnteroCsv(campos[2], &id)) {
+        snprintf(motivo, 100, "Uso: eliminar,<entidad>,<id>");
+        return false;
+    }
+
+    int entidad = entidadPorNombre(campos[1]);
+
+    if (entidad == ENTIDAD_PRODUCTO) {
+        int index = buscarProductoPorID(tienda, id);
+        if (index == -1) {
+            snprintf(motivo, 100, "No existe un producto con ID %d", id);
+            return false;
+        }
+        quitarProducto(tienda, index);
+    } else if (entidad == ENTIDAD_PROVEEDOR) {
+        int index = buscarProveedorPorID(tienda, id);
+        if (index == -1) {
+            snprintf(motivo, 100, "No existe un proveedor con ID %d", id);
+            return false;
+        }
+        if (productosDeProveedor(tienda, id) != nullptr) {
+            snprintf(motivo, 100, "El proveedor %d tiene productos asociados", id);
+            return false;
+        }
+        quitarProveedor(tienda, index);
+    } else if (entidad == ENTIDAD_CLIENTE) {
+        int index = buscarClientePorID(tienda, id);
+        if (index == -1) {
+            snprintf(motivo, 100, "No existe un cliente con ID %d", id);
+            return false;
+        }
+        for (int i = 0; i < tienda->transacciones.num; i++) {
+            if (tienda->transacciones[i].idRelacionado == id &&
+                strcmp(tienda->transacciones[i].tipo, "VENTA") == 0) {
+                snprintf(motivo, 100, "El cliente %d tiene ventas registradas", id);
+                return false;
+            }
+        }
+        quitarCliente(tienda, index);
+    } else {
+        snprintf(motivo, 100, "Entidad desconocida '%.40s'", campos[1]);
+        return false;
+    }
 
-        int index = -1;
+    compactarSiHaceFalta(tienda);
+    salida << "OK\n";
+    return true;
+}
 
-        switch (opcion) {
+bool comandoListar(Tienda* tienda, ostream& salida, char** campos, int n, char* motivo) {
+    int entidad = n == 2 || (n >= 4 && n <= 6) ? entidadPorNombre(campos[1]) : -1;
+    int desde = 0, limite = -1;
+    if (n >= 4 && (!leerEnteroCsv(campos[2], &desde) || !leerEnteroCsv(campos[3], &limite) ||
+                   desde < 0 || limite < 0))
+        entidad = -1;
+    int campo = n >= 5 ? campoOrdenPorNombre(campos[4], entidad) : ORDEN_REGISTRO;
+    bool descendente = n == 6 && strcmp(campos[5], "desc") == 0;
+    if (campo == -1 || (n == 6 && !descendente && strcmp(campos[5], "asc") != 0) ||
+        (descendente && campo == ORDEN_REGISTRO))
+        entidad = -1;
+    int listados;
+
+    if (entidad == ENTIDAD_PRODUCTO) {
+        const IndiceOrden* orden = campo == ORDEN_REGISTRO ? nullptr : ordenProductos(tienda, campo);
+        listados = paraCadaEnListado(orden, tienda->productos, descendente, desde, limite,
+                                     [&](Producto& p, int) { escribirProductoCsv(salida, p); });
+    } else if (entidad == ENTIDAD_PROVEEDOR) {
+        const IndiceOrden* orden = campo == ORDEN_NOMBRE ? ordenProveedores(tienda) : nullptr;
+        listados = paraCadaEnListado(orden, tienda->proveedores, descendente, desde, limite,
+                                     [&](Proveedor& p, int) { escribirProveedorCsv(salida, p); });
+    } else if (entidad == ENTIDAD_CLIENTE) {
+        const IndiceOrden* orden = campo == ORDEN_NOMBRE ? ordenClientes(tienda) : nullptr;
+        listados = paraCadaEnListado(orden, tienda->clientes, descendente, desde, limite,
+                                     [&](Cliente& c, int) { escribirClienteCsv(salida, c); });
+    } else {
+        snprintf(motivo, 100, "Uso: listar,<entidad>[,desde,limite[,registro|nombre|precio|stock|fecha[,asc|desc]]]");
+        return false;
+    }
 
-            case 1: {
-                int id;
-                cout << "Ingrese ID del proveedor: ";
-                cin >> id;
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    salida << "OK " << listados << '\n';
+    return true;
+}
 
-                index = buscarProveedorPorID(tienda, id);
-                break;
-            }
+bool comandoTicket(Tienda* tienda, ostream& salida, int tipo, char** campos, int n, char* motivo) {
+    int idRelacionado;
+    if (n < 4 || n % 2 != 0 || !leerEnteroCsv(campos[1], &idRelacionado)) {
+        snprintf(motivo, 100, "Uso: %s,<id>,<idProducto>,<cantidad>[,...]", campos[0]);
+        return false;
+    }
 
-            case 2: {
-                char nombre[100];
-                solicitarString("Ingrese nombre o parte del nombre: ", nombre, 100);
-                index = buscarProveedorPorNombre(tienda, nombre);
-                break;
-            }
+    int numLineas = (n - 2) / 2;
+    LineaTicket lineas[MAX_CAMPOS_COMANDO / 2];
+    for (int i = 0; i < numLineas; i++) {
+        if (!leerEnteroCsv(campos[2 + 2 * i], &lineas[i].idProducto) ||
+            !leerEnteroCsv(campos[3 + 2 * i], &lineas[i].cantidad)) {
+            snprintf(motivo, 100, "Lnea %d del ticket invlida", i + 1);
+            return false;
+        }
+        lineas[i].precioUnitario = 0;
+    }
 
-            case 3: {
-                char rif[20];
-                solicitarString("Ingrese RIF del proveedor: ", rif, 20);
-                index = buscarProveedorPorRIF(tienda, rif);
-                break;
-            }
+    Ticket ticket;
+    ticket.tipo = tipo;
+    ticket.idRelacionado = idRelacionado;
+    ticket.lineas = lineas;
+    ticket.numLineas = numLineas;
+    ticket.descripcion = nullptr;
 
-            default:
-                cout << "Opcin invlida.\n";
-                continue;
-        }
+    if (!procesarTickets(tienda, &ticket, 1, motivo, 100))
+        return false;
 
-        if (index == -1) {
-            cout << "No se encontr ningn proveedor con ese criterio.\n";
-        } else {
-            mostrarProveedor(tienda->proveedores[index]);
-        }
+    salida << "OK " << tienda->siguienteIdTransaccion - 1 << '\n';
+    return true;
+}
 
-        system("pause");
+// Responde "OK productos,unidades,valor" del inventario o de un proveedor
+bool comandoResumen(Tienda* tienda, ostream& salida, char** campos, int n, char* motivo) {
+    int idProveedor = 0;
+    if (n > 2 || (n == 2 && (!leerEnteroCsv(campos[1], &idProveedor) ||
+                             !existeProveedor(tienda, idProveedor)))) {
+        snprintf(motivo, 100, "Uso: resumen[,idProveedor existente]");
+        return false;
+    }
 
-    } while (opcion != 0);
+    TotalesInventario t = n == 2 ? totalesProveedor(tienda, idProveedor)
+                                 : agregadosDeInventario(tienda)->global;
+    salida << "OK " << t.productos << ',' << t.unidades << ',';
+    escribirCentavosCsv(salida, t.valorCentavos);
+    salida << '\n';
+    return true;
 }
 
-//2.3.3
+void escribirMovimientoCsv(ostream& salida, const Movimiento& m) {
+    salida << m.lineas << ',' << m.unidades << ',';
+    escribirCentavosCsv(salida, m.centavos);
+}
 
-void actualizarProveedor(Tienda* tienda) {
-    int id;
-    cout << "Ingrese el ID del proveedor a actualizar (0 para cancelar): ";
-    cin >> id;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+// reporte,dias|productos|proveedores,desde,hasta[,n[,unidades|ingresos]]
+bool comandoReporte(Tienda* tienda, ostream& salida, char** campos, int n, char* motivo) {
+    int desde, hasta, top = TOP_MAS_VENDIDOS;
+    bool porIngresos = false;
+    bool ok = n >= 4 && parsearFecha(campos[2], &desde) && parsearFecha(campos[3], &hasta);
+    if (ok && strcmp(campos[1], "productos") == 0) {
+        if (n >= 5) ok = leerEnteroCsv(campos[4], &top) && top > 0;
+        if (n == 6) {
+            porIngresos = strcmp(campos[5], "ingresos") == 0;
+            ok = ok && (porIngresos || strcmp(campos[5], "unidades") == 0);
+        }
+        ok = ok && n <= 6;
+    } else {
+        ok = ok && n == 4 && (strcmp(campos[1], "dias") == 0 || strcmp(campos[1], "proveedores") == 0);
+    }
+    if (!ok) {
+        snprintf(motivo, 100, "Uso: reporte,dias|productos|proveedores,desde,hasta[,n[,unidades|ingresos]]");
+        return false;
+    }
 
-    if (id == 0)
-        return;
+    int num = 0;
+    if (strcmp(campos[1], "dias") == 0) {
+        for (int fecha = desde; fecha <= hasta; fecha++) {
+            TotalesDia d = totalesDelDia(tienda, fecha);
+            if (d.ventas.lineas == 0 && d.compras.lineas == 0) continue;
+            escribirFechaCsv(salida, fecha);
+            salida << ',';
+            escribirMovimientoCsv(salida, d.ventas);
+            salida << ',';
+            escribirMovimientoCsv(salida, d.compras);
+            salida << '\n';
+            num++;
+        }
+    } else {
+        TotalAgrupado* grupos = strcmp(campos[1], "productos") == 0
+            ? productosMasVendidos(tienda, desde, hasta, top, porIngresos, &num)
+            : comprasPorProveedor(tienda, desde, hasta, &num);
+        for (int i = 0; i < num; i++) {
+            salida << grupos[i].clave << ',';
+            escribirMovimientoCsv(salida, grupos[i].total);
+            salida << '\n';
+        }
+        delete[] grupos;
+    }
+    salida << "OK " << num << '\n';
+    return true;
+}
 
-    int index = buscarProveedorPorID(tienda, id);
-    if (index == -1) {
-        cout << "ERROR: No existe un proveedor con ese ID.\n";
-        return;
+// Ejecuta una lnea ya separada en campos
+bool ejecutarComando(Tienda* tienda, ostream& salida, char** campos, int n, int hoy, char* motivo) {
+    const char* comando = campos[0];
+
+    if (strcmp(comando, "crear") == 0 && n >= 2)
+        return comandoCrear(tienda, salida, campos, n, hoy, motivo);
+    if (strcmp(comando, "buscar") == 0)
+        return comandoBuscar(tienda, salida, campos, n, motivo);
+    if (strcmp(comando, "stock") == 0)
+        return comandoStock(tienda, salida, campos, n, motivo);
+    if (strcmp(comando, "minimo") == 0)
+        return comandoMinimo(tienda, salida, campos, n, motivo);
+    if (strcmp(comando, "reponer") == 0)
+        return comandoReponer(tienda, salida, campos, n, motivo);
+    if (strcmp(comando, "eliminar") == 0)
+        return comandoEliminar(tienda, salida, campos, n, motivo);
+    if (strcmp(comando, "listar") == 0)
+        return comandoListar(tienda, salida, campos, n, motivo);
+    if (strcmp(comando, "compra") == 0)
+        return comandoTicket(tienda, salida, TICKET_COMPRA, campos, n, motivo);
+    if (strcmp(comando, "venta") == 0)
+        return comandoTicket(tienda, salida, TICKET_VENTA, campos, n, motivo);
+    if (strcmp(comando, "resumen") == 0)
+        return comandoResumen(tienda, salida, campos, n, motivo);
+    if (strcmp(comando, "reporte") == 0)
+        return comandoReporte(tienda, salida, campos, n, motivo);
+
+    if (strcmp(comando, "guardar") == 0 && n == 1) {
+        if (!guardarSnapshot(tienda, ARCHIVO_SNAPSHOT)) {
+            snprintf(motivo, 100, "No se pudo guardar %s", ARCHIVO_SNAPSHOT);
+            return false;
+        }
+        salida << "OK\n";
+        return true;
     }
 
-    Proveedor& original = tienda->proveedores[index];
-    Proveedor temp = original; // copia temporal
+    snprintf(motivo, 100, "Comando desconocido '%.40s'", comando);
+    return false;
+}
 
-    cout << "\n=== PROVEEDOR ENCONTRADO ===\n";
-    mostrarProveedor(original);
+// Lee las lneas de 'ruta' (o de la entrada estndar) y llama a
+// ejecutar(campos, n, hoy, motivo) por cada operacin, con la fecha del
+// momento en que se ejecuta (una sesin larga puede pasar la medianoche).
+// Devuelve el nmero de operaciones que fallaron (-1 si no se pudo abrir la
+// entrada).
+template <typename F>
+long long leerComandos(const char* ruta, F ejecutar) {
+    FILE* entrada = stdin;
+    if (ruta != nullptr) {
+        entrada = fopen(ruta, "rb");
+        if (entrada == nullptr) {
+            cout << "ERROR: No se pudo abrir '" << ruta << "'.\n";
+            return -1;
+        }
+    }
 
-    if (!confirmar("\nDesea modificar este proveedor? (S/N): "))
-        return;
+    char* linea = new char[MAX_LINEA_COMANDO];
+    char* campos[MAX_CAMPOS_COMANDO];
+    char motivo[100];
+    long long numLinea = 0, errores = 0;
+
+    while (fgets(linea, MAX_LINEA_COMANDO, entrada) != nullptr) {
+        numLinea++;
+
+        size_t len = strlen(linea);
+        bool completa = len > 0 && linea[len - 1] == '\n';
+        if (!completa && !feof(entrada)) {
+            // Lnea demasiado larga: se descarta el resto
+            int c;
+            while ((c = fgetc(entrada)) != EOF && c != '\n') {}
+            cout << "ERROR " << numLinea << ": Lnea demasiado larga\n";
+            errores++;
+            continue;
+        }
+        while (len > 0 && (linea[len - 1] == '\n' || linea[len - 1] == '\r'))
+            linea[--len] = '\0';
 
-    // --- Nombre ---
-    cout << "\nNombre actual: " << temp.nombre << endl;
-    solicitarString("Nuevo nombre (ENTER para mantener): ", temp.nombre, 100);
-    if (strlen(temp.nombre) == 0)
-        strcpy(temp.nombre, original.nombre);
+        if (len == 0 || linea[0] == '#')
+            continue;
 
-    // --- RIF ---
-    cout << "\nRIF actual: " << temp.rif << endl;
-    solicitarString("Nuevo RIF (ENTER para mantener): ", temp.rif, 20);
-    if (strlen(temp.rif) == 0)
-        strcpy(temp.rif, original.rif);
-    else if (rifDuplicado(tienda, temp.rif, original.id)) {
-        cout << "ERROR: El RIF '" << temp.rif << "' ya est registrado.\n";
-        return;
+        int n = separarCamposCsv(linea, campos, MAX_CAMPOS_COMANDO);
+        bool ok;
+        if (n < 0) {
+            snprintf(motivo, sizeof(motivo), "Lnea mal formada");
+            ok = false;
+        } else {
+            ok = ejecutar(campos, n, fechaActual(), motivo);
+        }
+
+        if (!ok) {
+            cout << "ERROR " << numLinea << ": " << motivo << '\n';
+            errores++;
+        }
     }
 
-    // --- Telfono ---
-    cout << "\nTelfono actual: " << temp.telefono << endl;
-    solicitarString("Nuevo telfono (ENTER para mantener): ", temp.telefono, 20);
-    if (strlen(temp.telefono) == 0)
-        strcpy(temp.telefono, original.telefono);
+    delete[] linea;
+    if (entrada != stdin)
+        fclose(entrada);
+    return errores;
+}
 
-    // --- Email ---
-    cout << "\nEmail actual: " << temp.email << endl;
-    solicitarString("Nuevo email (ENTER para mantener): ", temp.email, 100);
-    if (strlen(temp.email) == 0)
-        strcpy(temp.email, original.email);
-    else if (!emailValido(temp.email)) {
-        cout << "ERROR: El email debe contener '@' y un dominio.\n";
-        return;
-    }
+long long ejecutarComandos(Tienda* tienda, const char* ruta) {
+    long long errores = leerComandos(ruta, [tienda](char** campos, int n, int hoy, char* motivo) {
+        return ejecutarComando(tienda, cout, campos, n, hoy, motivo);
+    });
+    if (errores < 0)
+        return errores;
+
+    if (!confirmarCambios(tienda))
+        errores++;
+    cout.flush();
+    return errores;
+}
 
-    // --- Direccin ---
-    cout << "\nDireccin actual: " << temp.direccion << endl;
-    solicitarString("Nueva direccin (ENTER para mantener): ", temp.direccion, 200);
-    if (strlen(temp.direccion) == 0)
-        strcpy(temp.direccion, original.direccion);
+//======================
+//3.5 benchmark
+//======================
 
-    // --- Confirmacin final ---
-    cout << "\n=== NUEVOS DATOS DEL PROVEEDOR ===\n";
-    mostrarProveedor(temp);
+// inventario --bench [n1 n2 ...]
+//
+// Genera, para cada tamao n (por defecto 10^3 a 10^6), una tienda sinttica
+// en memoria con datos deterministas y mide cada operacin. No toca
+// tienda.dat ni el WAL. Escribe una lnea JSON por (n, operacin) en la salida
+// estndar para poder comparar entre versiones; el progreso va a stderr.
 
-    if (!confirmar("Guardar cambios? (S/N): "))
-        return;
+const unsigned long long SEMILLA_BENCH = 20240601ULL;
 
-    original = temp;
-    cout << "Proveedor actualizado exitosamente.\n";
+// xorshift64*: rpido y siempre la misma secuencia para la misma semilla
+struct Aleatorio {
+    unsigned long long estado;
+};
+
+unsigned int siguienteAleatorio(Aleatorio* a) {
+    a->estado ^= a->estado >> 12;
+    a->estado ^= a->estado << 25;
+    a->estado ^= a->estado >> 27;
+    return (unsigned int)((a->estado * 2685821657736338717ULL) >> 32);
 }
 
-//2.3.4
+int aleatorioEntre(Aleatorio* a, int minimo, int maximo) {
+    return minimo + (int)(siguienteAleatorio(a) % (unsigned int)(maximo - minimo + 1));
+}
 
-void listarProveedores(Tienda* tienda) {
-    if (tienda->numProveedores == 0) {
-        cout << "No hay proveedores registrados.\n";
-        return;
-    }
+const char* const PALABRAS_BENCH[] = {
+    "Arroz", "Harina", "Aceite", "Azucar", "Cafe", "Leche", "Queso", "Pasta",
+    "Atun", "Sardina", "Jabon", "Detergente", "Cloro", "Galleta", "Refresco", "Jugo",
+    "Mantequilla", "Mayonesa", "Salsa", "Avena", "Caraotas", "Lentejas", "Papel", "Champu"
+};
+const char* const VARIANTES_BENCH[] = {
+    "Blanco", "Integral", "Premium", "Light", "Familiar", "Clasico", "Extra", "Natural"
+};
+const int NUM_PALABRAS_BENCH = sizeof(PALABRAS_BENCH) / sizeof(PALABRAS_BENCH[0]);
+const int NUM_VARIANTES_BENCH = sizeof(VARIANTES_BENCH) / sizeof(VARIANTES_BENCH[0]);
+
+// Los productos sintticos se reparten en los ltimos diez aos
+const int DIAS_HISTORIA_BENCH = 3650;
+
+void generarProductoBench(Aleatorio* a, int numero, int numProveedores, int hoy, Producto* p) {
+    memset(p, 0, sizeof(*p));
+    snprintf(p->codigo, sizeof(p->codigo), "PRD-%08d", numero);
+    snprintf(p->nombre, sizeof(p->nombre), "%s %s %dg",
+             PALABRAS_BENCH[siguienteAleatorio(a) % NUM_PALABRAS_BENCH],
+             VARIANTES_BENCH[siguienteAleatorio(a) % NUM_VARIANTES_BENCH],
+             aleatorioEntre(a, 1, 20) * 50);
+    snprintf(p->descripcion, sizeof(p->descripcion), "Producto de prueba numero %d", numero);
+    p->idProveedor = aleatorioEntre(a, 1, numProveedores);
+    p->precio = aleatorioEntre(a, 50, 50000) / 100.0f;
+    p->stock = aleatorioEntre(a, 1000, 100000);
+    p->fechaRegistro = hoy - aleatorioEntre(a, 0, DIAS_HISTORIA_BENCH - 1);
+    // Sin sacar otro nmero, para no cambiar el resto de los datos
+    p->stockMinimo = (int)((numero * 7919LL) % 20000);
+}
 
-    encabezadoProveedores();
+// Proveedores y clientes de la tienda sinttica (sin medir)
+void poblarTiendaBench(Tienda* tienda, Aleatorio* a, int numProveedores, int numClientes, int hoy) {
+    char motivo[100];
+
+    for (int i = 1; i <= numProveedores; i++) {
+        Proveedor p;
+        memset(&p, 0, sizeof(p));
+        snprintf(p.rif, sizeof(p.rif), "J-%08d", i);
+        snprintf(p.nombre, sizeof(p.nombre), "Distribuidora %s %d",
+                 PALABRAS_BENCH[siguienteAleatorio(a) % NUM_PALABRAS_BENCH], i);
+        strcpy(p.email, "ventas@proveedor.com");
+        strcpy(p.telefono, "0212-5550000");
+        p.fechaRegistro = hoy;
+        altaProveedor(tienda, &p, motivo);
+    }
 
-    for (int i = 0; i < tienda->numProveedores; i++) {
-        filaProveedor(tienda->proveedores[i]);
+    for (int i = 1; i <= numClientes; i++) {
+        Cliente c;
+        memset(&c, 0, sizeof(c));
+        snprintf(c.cedula, sizeof(c.cedula), "V-%08d", i);
+        snprintf(c.nombre, sizeof(c.nombre), "Cliente %d", i);
+        strcpy(c.email, "cliente@correo.com");
+        strcpy(c.telefono, "0414-5550000");
+        c.fechaRegistro = hoy;
+        altaCliente(tienda, &c, motivo);
     }
+}
+
+long long ahoraNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-    pieProveedores();
+// Latencias de una operacin (ns por llamada). El tiempo total es la suma de
+// las latencias, sin contar la generacin de los datos de cada llamada.
+struct MedicionBench {
+    long long* latencias;
+    int num;
+};
 
-    cout << "\nTotal de proveedores: " << tienda->numProveedores << "\n";
+void iniciarMedicion(MedicionBench* m, int maxOps) {
+    m->latencias = new long long[max(maxOps, 1)];
+    m->num = 0;
 }
 
-//2.3.5
+void reportarMedicion(MedicionBench* m, const char* operacion, int n) {
+    long long total = 0;
+    for (int i = 0; i < m->num; i++)
+        total += m->latencias[i];
+    sort(m->latencias, m->latencias + m->num);
 
-void eliminarProveedor(Tienda* tienda) {
-    int id;
-    cout << "Ingrese el ID del proveedor a eliminar (0 para cancelar): ";
-    cin >> id;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    long long p50 = m->num > 0 ? m->latencias[m->num / 2] : 0;
+    long long p99 = m->num > 0 ? m->latencias[min(m->num - 1, (int)(m->num * 0.99))] : 0;
+    double segundos = total / 1e9;
 
-    if (id == 0)
-        return;
+    printf("{\"n\":%d,\"operacion\":\"%s\",\"ops\":%d,\"segundos\":%.6f,"
+           "\"ops_por_segundo\":%.1f,\"p50_us\":%.3f,\"p99_us\":%.3f}\n",
+           n, operacion, m->num, segundos, segundos > 0 ? m->num / segundos : 0.0,
+           p50 / 1000.0, p99 / 1000.0);
+    fflush(stdout);
 
-    int index = buscarProveedorPorID(tienda, id);
-    if (index == -1) {
-        cout << "ERROR: No existe un proveedor con ese ID.\n";
-        return;
-    }
+    delete[] m->latencias;
+    m->latencias = nullptr;
+}
 
-    Proveedor& p = tienda->proveedores[index];
+// Dispositivo nulo; sirve para medir el formateo del listado sin el costo
+// de la consola
+#ifdef _WIN32
+const char DISPOSITIVO_NULO[] = "NUL";
+#else
+const char DISPOSITIVO_NULO[] = "/dev/null";
+#endif
 
-    cout << "\n=== PROVEEDOR A ELIMINAR ===\n";
-    mostrarProveedor(p);
+void benchTienda(int n) {
+    Aleatorio a;
+    a.estado = SEMILLA_BENCH ^ (unsigned long long)n;
 
-    // --- Verificar si tiene productos asociados ---
-    bool tieneProductos = false;
+    int hoy = fechaActual();
 
-    for (int i = 0; i < tienda->numProductos; i++) {
-        if (tienda->productos[i].idProveedor == id) {
-            tieneProductos = true;
-            break;
+    Tienda tienda;
+    inicializarTienda(&tienda, "Tienda de prueba", "J-00000000");
+
+    int numProveedores = max(n / 100, 1);
+    int numClientes = max(n / 10, 1);
+    poblarTiendaBench(&tienda, &a, numProveedores, numClientes, hoy);
+
+    char motivo[100];
+    MedicionBench m;
+
+    // Altas (incluye la verificacin de cdigo duplicado y el crecimiento)
+    cerr << "n=" << n << ": insertar\n";
+    iniciarMedicion(&m, n);
+    for (int i = 1; i <= n; i++) {
+        Producto p;
+        generarProductoBench(&a, i, numProveedores, hoy, &p);
+        long long t0 = ahoraNs();
+        altaProducto(&tienda, &p, motivo);
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "insertar", n);
+
+    const int OPS_PUNTUALES = 200000;
+
+    cerr << "n=" << n << ": buscar_id\n";
+    buscarProductoPorID(&tienda, 1);
+    iniciarMedicion(&m, OPS_PUNTUALES);
+    for (int i = 0; i < OPS_PUNTUALES; i++) {
+        int id = aleatorioEntre(&a, 1, n);
+        long long t0 = ahoraNs();
+        buscarProductoPorID(&tienda, id);
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "buscar_id", n);
+
+    cerr << "n=" << n << ": buscar_codigo\n";
+    iniciarMedicion(&m, OPS_PUNTUALES);
+    for (int i = 0; i < OPS_PUNTUALES; i++) {
+        char codigo[20];
+        snprintf(codigo, sizeof(codigo), "PRD-%08d", aleatorioEntre(&a, 1, n));
+        long long t0 = ahoraNs();
+        idPorCodigo(&tienda, codigo);
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "buscar_codigo", n);
+
+    cerr << "n=" << n << ": codigo_duplicado\n";
+    iniciarMedicion(&m, OPS_PUNTUALES);
+    for (int i = 0; i < OPS_PUNTUALES; i++) {
+        char codigo[20];
+        snprintf(codigo, sizeof(codigo), "NUEVO-%08d", aleatorioEntre(&a, 1, n));
+        long long t0 = ahoraNs();
+        codigoProductoDuplicado(&tienda, codigo);
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "codigo_duplicado", n);
+
+    // Subcadena de 4 letras de una palabra del catlogo
+    cerr << "n=" << n << ": buscar_nombre\n";
+    const int OPS_NOMBRE = 500;
+    int numResultados;
+    delete[] buscarProductosPorNombre(&tienda, "Arroz", &numResultados);
+    iniciarMedicion(&m, OPS_NOMBRE);
+    for (int i = 0; i < OPS_NOMBRE; i++) {
+        const char* palabra = PALABRAS_BENCH[siguienteAleatorio(&a) % NUM_PALABRAS_BENCH];
+        int largo = strlen(palabra);
+        char patron[8];
+        int desde = largo > 4 ? aleatorioEntre(&a, 0, largo - 4) : 0;
+        snprintf(patron, sizeof(patron), "%.4s", palabra + desde);
+
+        long long t0 = ahoraNs();
+        int* resultados = buscarProductosPorNombre(&tienda, patron, &numResultados);
+        delete[] resultados;
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "buscar_nombre", n);
+
+    // El mismo tipo de patrn, recorriendo toda la tabla sin el ndice
+    cerr << "n=" << n << ": escanear_nombre\n";
+    const int OPS_ESCANEO = 20;
+    iniciarMedicion(&m, OPS_ESCANEO);
+    for (int i = 0; i < OPS_ESCANEO; i++) {
+        const char* palabra = PALABRAS_BENCH[siguienteAleatorio(&a) % NUM_PALABRAS_BENCH];
+        int largo = strlen(palabra);
+        char texto[8];
+        int desde = largo > 4 ? aleatorioEntre(&a, 0, largo - 4) : 0;
+        snprintf(texto, sizeof(texto), "%.4s", palabra + desde);
+
+        long long t0 = ahoraNs();
+        PatronTexto patron;
+        prepararPatron(&patron, texto);
+        delete[] filtrarPorTexto(tienda.productos, &Producto::nombre, &patron, &numResultados);
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "escanear_nombre", n);
+
+    // Productos registrados en una ventana de 30 das
+    cerr << "n=" << n << ": buscar_fecha\n";
+    const int OPS_FECHA = 2000;
+    delete[] productosRegistradosEntre(&tienda, hoy, hoy, &numResultados);
+    iniciarMedicion(&m, OPS_FECHA);
+    for (int i = 0; i < OPS_FECHA; i++) {
+        int desde = hoy - aleatorioEntre(&a, 0, DIAS_HISTORIA_BENCH - 1);
+        long long t0 = ahoraNs();
+        delete[] productosRegistradosEntre(&tienda, desde, desde + 29, &numResultados);
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "buscar_fecha", n);
+
+    // Totales por proveedor: la primera consulta recorre la tabla, las
+    // siguientes leen lo que mantienen las altas y los cambios de stock
+    cerr << "n=" << n << ": resumen\n";
+    const int OPS_RESUMEN = 2000;
+    agregadosDeInventario(&tienda);
+    iniciarMedicion(&m, OPS_RESUMEN);
+    for (int i = 0; i < OPS_RESUMEN; i++) {
+        int index = aleatorioEntre(&a, 0, n - 1);
+        long long t0 = ahoraNs();
+        if (activo(tienda.productos[index]))
+            fijarStockProducto(&tienda, index, aleatorioEntre(&a, 0, 1000));
+        totalesProveedor(&tienda, aleatorioEntre(&a, 1, numProveedores));
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "resumen", n);
+
+    // Reposicin: cada cambio de stock mueve un producto del montculo y la
+    // consulta lee solo los primeros
+    cerr << "n=" << n << ": reponer\n";
+    const int OPS_REPONER = 2000;
+    reposicionDeProductos(&tienda);
+    iniciarMedicion(&m, OPS_REPONER);
+    for (int i = 0; i < OPS_REPONER; i++) {
+        int index = aleatorioEntre(&a, 0, n - 1);
+        int idProveedor = i % 2 == 0 ? 0 : aleatorioEntre(&a, 1, numProveedores);
+        long long t0 = ahoraNs();
+        if (activo(tienda.productos[index]))
+            fijarStockProducto(&tienda, index, aleatorioEntre(&a, 0, 1000));
+        delete[] productosPorReponer(&tienda, 20, idProveedor, &numResultados);
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "reponer", n);
+
+    FILE* nulo = fopen(DISPOSITIVO_NULO, "wb");
+    if (nulo != nullptr) {
+        cerr << "n=" << n << ": listar\n";
+        const int OPS_LISTAR = 3;
+        iniciarMedicion(&m, OPS_LISTAR);
+        for (int i = 0; i < OPS_LISTAR; i++) {
+            long long t0 = ahoraNs();
+            tablaProductos(&tienda, nulo, 0, -1);
+            m.latencias[m.num++] = ahoraNs() - t0;
+        }
+        reportarMedicion(&m, "listar", n);
+
+        cerr << "n=" << n << ": listar_pagina\n";
+        const int OPS_PAGINA = 2000;
+        iniciarMedicion(&m, OPS_PAGINA);
+        for (int i = 0; i < OPS_PAGINA; i++) {
+            int desde = aleatorioEntre(&a, 0, n - 1);
+            long long t0 = ahoraNs();
+            tablaProductos(&tienda, nulo, desde, FILAS_POR_PAGINA);
+            m.latencias[m.num++] = ahoraNs() - t0;
         }
+        reportarMedicion(&m, "listar_pagina", n);
+
+        // El ndice por precio se arma fuera de la medicin, como lo hara
+        // prepararLecturas
+        ordenProductos(&tienda, ORDEN_PRECIO);
+        cerr << "n=" << n << ": listar_orden\n";
+        iniciarMedicion(&m, OPS_PAGINA);
+        for (int i = 0; i < OPS_PAGINA; i++) {
+            int desde = aleatorioEntre(&a, 0, n - 1);
+            long long t0 = ahoraNs();
+            tablaProductosEnOrden(&tienda, nulo, desde, FILAS_POR_PAGINA, ORDEN_PRECIO, true);
+            m.latencias[m.num++] = ahoraNs() - t0;
+        }
+        reportarMedicion(&m, "listar_orden", n);
+        fclose(nulo);
     }
 
-    if (tieneProductos) {
-        cout << "\nADVERTENCIA: Este proveedor tiene productos asociados.\n";
-        cout << "No se puede eliminar mientras existan productos vinculados.\n";
-        return;
+    // Historial sinttico (sin medir): n lneas repartidas en orden por los
+    // das anteriores a hoy, para que los reportes tengan qu recorrer
+    const int LOTE_HISTORIAL = 4096;
+    Transaccion* historial = new Transaccion[LOTE_HISTORIAL];
+    for (int i = 0; i < n; i += LOTE_HISTORIAL) {
+        int num = min(LOTE_HISTORIAL, n - i);
+        for (int k = 0; k < num; k++) {
+            Transaccion& t = historial[k];
+            memset(&t, 0, sizeof(t));
+            bool venta = aleatorioEntre(&a, 0, 3) > 0;
+            t.id = tienda.siguienteIdTransaccion + k;
+            strcpy(t.tipo, venta ? "VENTA" : "COMPRA");
+            t.idProducto = aleatorioEntre(&a, 1, n);
+            t.idRelacionado = venta ? aleatorioEntre(&a, 1, numClientes) : aleatorioEntre(&a, 1, numProveedores);
+            t.cantidad = aleatorioEntre(&a, 1, 5);
+            t.precioUnitario = aleatorioEntre(&a, 50, 50000) / 100.0f;
+            t.total = t.cantidad * t.precioUnitario;
+            t.fecha = hoy - DIAS_HISTORIA_BENCH + (int)((long long)(i + k) * DIAS_HISTORIA_BENCH / n);
+        }
+        asentarTransacciones(&tienda, historial, num);
+    }
+    delete[] historial;
+
+    // Ventas de un ticket de una lnea
+    cerr << "n=" << n << ": venta\n";
+    const int OPS_VENTA = 100000;
+    iniciarMedicion(&m, OPS_VENTA);
+    for (int i = 0; i < OPS_VENTA; i++) {
+        LineaTicket linea;
+        linea.idProducto = aleatorioEntre(&a, 1, n);
+        linea.cantidad = 1;
+        linea.precioUnitario = 0;
+
+        Ticket ticket;
+        ticket.tipo = TICKET_VENTA;
+        ticket.idRelacionado = aleatorioEntre(&a, 1, numClientes);
+        ticket.lineas = &linea;
+        ticket.numLineas = 1;
+        ticket.descripcion = nullptr;
+
+        long long t0 = ahoraNs();
+        procesarTickets(&tienda, &ticket, 1, motivo, sizeof(motivo));
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "venta", n);
+
+    // Reportes sobre un mes al azar del historial
+    const int OPS_REPORTE = 200;
+    columnasDeTransacciones(&tienda);
+    FILE* reportes = fopen(DISPOSITIVO_NULO, "wb");
+    if (reportes != nullptr) {
+        cerr << "n=" << n << ": reporte_dias\n";
+        iniciarMedicion(&m, OPS_REPORTE);
+        for (int i = 0; i < OPS_REPORTE; i++) {
+            int desde = hoy - aleatorioEntre(&a, 30, DIAS_HISTORIA_BENCH);
+            long long t0 = ahoraNs();
+            tablaVentasPorDia(&tienda, reportes, desde, desde + 29);
+            m.latencias[m.num++] = ahoraNs() - t0;
+        }
+        reportarMedicion(&m, "reporte_dias", n);
+        fclose(reportes);
     }
 
-    // --- Confirmacin ---
-    if (!confirmar("\nEliminar proveedor? (S/N): ")) {
-        cout << "Eliminacin cancelada.\n";
-        return;
+    cerr << "n=" << n << ": reporte_top\n";
+    iniciarMedicion(&m, OPS_REPORTE);
+    for (int i = 0; i < OPS_REPORTE; i++) {
+        int desde = hoy - aleatorioEntre(&a, 30, DIAS_HISTORIA_BENCH);
+        long long t0 = ahoraNs();
+        delete[] productosMasVendidos(&tienda, desde, desde + 29, TOP_MAS_VENDIDOS, i % 2, &numResultados);
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "reporte_top", n);
+
+    cerr << "n=" << n << ": reporte_proveedores\n";
+    iniciarMedicion(&m, OPS_REPORTE);
+    for (int i = 0; i < OPS_REPORTE; i++) {
+        int desde = hoy - aleatorioEntre(&a, 30, DIAS_HISTORIA_BENCH);
+        long long t0 = ahoraNs();
+        delete[] comprasPorProveedor(&tienda, desde, desde + 29, &numResultados);
+        m.latencias[m.num++] = ahoraNs() - t0;
     }
+    reportarMedicion(&m, "reporte_proveedores", n);
+
+    // Bsquedas por id y por cdigo desde varias cajas mientras otra cambia
+    // stock, todas a travs de la tienda compartida
+    cerr << "n=" << n << ": leer_concurrente\n";
+    TiendaCompartida compartida;
+    compartirTienda(&compartida, &tienda);
+    int numLectores = max(2, min((int)thread::hardware_concurrency(), 8));
+    const int OPS_POR_LECTOR = 50000;
+    const int OPS_ESCRITOR = 2000;
+    iniciarMedicion(&m, numLectores * OPS_POR_LECTOR);
+    thread* lectores = new thread[numLectores];
+    for (int h = 0; h < numLectores; h++) {
+        lectores[h] = thread([&, h] {
+            Aleatorio propio;
+            propio.estado = SEMILLA_BENCH ^ (unsigned long long)(h + 1) << 32;
+            long long* latencias = m.latencias + (long long)h * OPS_POR_LECTOR;
+            for (int i = 0; i < OPS_POR_LECTOR; i++) {
+                char codigo[20];
+                snprintf(codigo, sizeof(codigo), "PRD-%08d", aleatorioEntre(&propio, 1, n));
+                int id = aleatorioEntre(&propio, 1, n);
+                long long t0 = ahoraNs();
+                leerTienda(&compartida, [&](Tienda* t) {
+                    buscarProductoPorID(t, idPorCodigo(t, codigo));
+                    buscarProductoPorID(t, id);
+                });
+                latencias[i] = ahoraNs() - t0;
+            }
+        });
+    }
+    for (int i = 0; i < OPS_ESCRITOR; i++) {
+        int id = aleatorioEntre(&a, 1, n);
+        int stock = aleatorioEntre(&a, 0, 1000);
+        modificarTienda(&compartida, [&](Tienda* t) {
+            int index = buscarProductoPorID(t, id);
+            if (index != -1)
+                fijarStockProducto(t, index, stock);
+        });
+    }
+    for (int h = 0; h < numLectores; h++)
+        lectores[h].join();
+    delete[] lectores;
+    m.num = numLectores * OPS_POR_LECTOR;
+    reportarMedicion(&m, "leer_concurrente", n);
+
+    // Bajas de un 10% de los productos, en orden aleatorio
+    cerr << "n=" << n << ": eliminar\n";
+    int numBajas = max(n / 10, 1);
+    int* ids = new int[n];
+    for (int i = 0; i < n; i++)
+        ids[i] = i + 1;
+    for (int i = 0; i < numBajas; i++)
+        swap(ids[i], ids[aleatorioEntre(&a, i, n - 1)]);
+
+    iniciarMedicion(&m, numBajas);
+    for (int i = 0; i < numBajas; i++) {
+        long long t0 = ahoraNs();
+        int index = buscarProductoPorID(&tienda, ids[i]);
+        if (index != -1) {
+            quitarProducto(&tienda, index);
+            compactarSiHaceFalta(&tienda);
+        }
+        m.latencias[m.num++] = ahoraNs() - t0;
+    }
+    reportarMedicion(&m, "eliminar", n);
+
+    delete[] ids;
+    liberarTienda(&tienda);
+}
 
-    // --- Eliminar moviendo elementos ---
-    for (int i = index; i < tienda->numProveedores - 1; i++) {
-        tienda->proveedores[i] = tienda->proveedores[i + 1];
+int ejecutarBench(int argc, char* argv[]) {
+    int tamanos[16];
+    int numTamanos = 0;
+
+    for (int i = 2; i < argc && numTamanos < 16; i++) {
+        int n;
+        if (!leerEnteroCsv(argv[i], &n) || n <= 0) {
+            cerr << "ERROR: Tamao invlido '" << argv[i] << "'.\n";
+            return 1;
+        }
+        tamanos[numTamanos++] = n;
     }
 
-    tienda->numProveedores--;
+    if (numTamanos == 0) {
+        for (int n = 1000; n <= 1000000; n *= 10)
+            tamanos[numTamanos++] = n;
+    }
 
-    cout << "Proveedor eliminado exitosamente.\n";
+    for (int i = 0; i < numTamanos; i++)
+        benchTienda(tamanos[i]);
+    return 0;
 }
 
-//=======================
-//2.4
-//=======================
+//======================
+//3.6 servidor
+//======================
 
-void crearCliente(Tienda* tienda) {
-    if (!confirmar("Desea registrar un nuevo cliente? (S/N): "))
-        return;
+// inventario --servidor <puerto|ruta>
+//
+// Atiende las operaciones del modo por lotes por un socket local: un puerto
+// TCP en 127.0.0.1 si el argumento es un nmero, o un socket Unix en esa ruta
+// si no. Cada peticin es una lnea con el mismo formato; la respuesta son
+// los registros CSV que correspondan y una ltima lnea "OK ..." o
+// "ERROR <lnea>: <motivo>", con la lnea contada dentro de esa conexin. Se
+// pueden mandar varias peticiones sin esperar las respuestas: se contestan
+// en orden.
+//
+// Un solo hilo atiende todas las conexiones con epoll. Las peticiones que
+// llegan en una vuelta se ejecutan una tras otra y, si alguna cambi algo,
+// se espera una sola vez el fsync del WAL antes de enviar las respuestas de
+// esa vuelta, as ningn cliente recibe un OK que no est en disco. Termina
+// con SIGINT o SIGTERM.
+
+#ifdef SERVIDOR_EPOLL
+
+const int TAM_ENTRADA_CONEXION = 64 * 1024;
+const long long LIMITE_SALIDA_CONEXION = 1 << 20;   // deja de leer por encima
+const int MAX_EVENTOS_SERVIDOR = 256;
+
+struct ConexionServidor {
+    int fd;
+    char* entrada;             // bytes recibidos que an no forman una lnea procesada
+    int usadoEntrada;
+    char* salida;              // respuestas por enviar
+    long long usadoSalida;
+    long long enviadoSalida;
+    long long capacidadSalida;
+    long long numLinea;
+    unsigned int eventos;      // los registrados en epoll
+    bool lineasPendientes;     // quedaron lneas completas sin ejecutar
+    bool cerrar;               // cerrar cuando no quede nada por enviar
+    bool enVuelta;
+};
 
-    Cliente nuevo;
+volatile sig_atomic_t servidorDetenido = 0;
 
-    // --- Cdula / RIF ---
-    solicitarString(
-        "Ingrese cdula/RIF del cliente (o CANCELAR): ",
-        nuevo.cedula,
-        20
-    );
+void detenerServidor(int) {
+    servidorDetenido = 1;
+}
 
-    if (strcmp(nuevo.cedula, "CANCELAR") == 0 || strcmp(nuevo.cedula, "0") == 0)
-        return;
+ConexionServidor* nuevaConexion(int fd) {
+    ConexionServidor* c = new ConexionServidor;
+    c->fd = fd;
+    c->entrada = new char[TAM_ENTRADA_CONEXION];
+    c->usadoEntrada = 0;
+    c->capacidadSalida = 16 * 1024;
+    c->salida = new char[c->capacidadSalida];
+    c->usadoSalida = 0;
+    c->enviadoSalida = 0;
+    c->numLinea = 0;
+    c->eventos = EPOLLIN;
+    c->lineasPendientes = false;
+    c->cerrar = false;
+    c->enVuelta = false;
+    return c;
+}
 
-    if (clienteDuplicado(tienda, nuevo.cedula)) {
-        cout << "ERROR: La cdula/RIF '" << nuevo.cedula << "' ya est registrada.\n";
-        return;
+void liberarConexion(ConexionServidor* c) {
+    close(c->fd);
+    delete[] c->entrada;
+    delete[] c->salida;
+    delete c;
+}
+
+long long salidaPendiente(const ConexionServidor* c) {
+    return c->usadoSalida - c->enviadoSalida;
+}
+
+void agregarSalida(ConexionServidor* c, const char* datos, long long len) {
+    if (c->usadoSalida + len > c->capacidadSalida) {
+        // Primero se recupera lo ya enviado; si no alcanza, se crece
+        long long pendiente = salidaPendiente(c);
+        long long nuevaCap = c->capacidadSalida;
+        while (pendiente + len > nuevaCap) nuevaCap *= 2;
+
+        char* nueva = nuevaCap == c->capacidadSalida ? c->salida : new char[nuevaCap];
+        memmove(nueva, c->salida + c->enviadoSalida, (size_t)pendiente);
+        if (nueva != c->salida) {
+            delete[] c->salida;
+            c->salida = nueva;
+            c->capacidadSalida = nuevaCap;
+        }
+        c->usadoSalida = pendiente;
+        c->enviadoSalida = 0;
     }
+    memcpy(c->salida + c->usadoSalida, datos, (size_t)len);
+    c->usadoSalida += len;
+}
 
-    // --- Nombre ---
-    solicitarString("Ingrese nombre del cliente (o CANCELAR): ",
-                    nuevo.nombre, 100);
+// Ejecuta las lneas completas recibidas, en orden, mientras la salida no
+// pase del lmite
+void procesarEntrada(Tienda* tienda, ConexionServidor* c, ostringstream& respuesta, int hoy) {
+    char* campos[MAX_CAMPOS_COMANDO];
+    char motivo[100];
+    int inicio = 0;
+
+    c->lineasPendientes = false;
+    while (inicio < c->usadoEntrada) {
+        if (salidaPendiente(c) >= LIMITE_SALIDA_CONEXION) {
+            c->lineasPendientes = memchr(c->entrada + inicio, '\n', c->usadoEntrada - inicio) != nullptr;
+            break;
+        }
 
-    if (strcmp(nuevo.nombre, "CANCELAR") == 0 || strcmp(nuevo.nombre, "0") == 0)
-        return;
+        char* linea = c->entrada + inicio;
+        char* fin = (char*)memchr(linea, '\n', c->usadoEntrada - inicio);
+        if (fin == nullptr) {
+            if (c->usadoEntrada - inicio >= MAX_LINEA_COMANDO) {
+                respuesta << "ERROR " << c->numLinea + 1 << ": Lnea demasiado larga\n";
+                c->cerrar = true;
+                inicio = c->usadoEntrada;
+            }
+            break;
+        }
+        inicio = fin - c->entrada + 1;
+        c->numLinea++;
 
-    // --- Email ---
-    solicitarString(
-        "Ingrese email del cliente (o CANCELAR): ",
-        nuevo.email,
-        100,
-        emailValido,
-        "ERROR: El email debe contener '@' y un punto.\n"
-    );
+        int len = fin - linea;
+        while (len > 0 && linea[len - 1] == '\r') len--;
+        linea[len] = '\0';
+        if (len == 0 || linea[0] == '#')
+            continue;
+
+        bool ok;
+        if (len >= MAX_LINEA_COMANDO) {
+            snprintf(motivo, sizeof(motivo), "Lnea demasiado larga");
+            ok = false;
+        } else {
+            int n = separarCamposCsv(linea, campos, MAX_CAMPOS_COMANDO);
+            if (n < 0) {
+                snprintf(motivo, sizeof(motivo), "Lnea mal formada");
+                ok = false;
+            } else {
+                ok = ejecutarComando(tienda, respuesta, campos, n, hoy, motivo);
+            }
+        }
+        if (!ok)
+            respuesta << "ERROR " << c->numLinea << ": " << motivo << '\n';
 
-    if (strcmp(nuevo.email, "CANCELAR") == 0 || strcmp(nuevo.email, "0") == 0)
-        return;
+        string texto = respuesta.str();
+        agregarSalida(c, texto.data(), texto.size());
+        respuesta.str("");
+    }
 
-    // --- Telfono ---
-    solicitarString("Ingrese telfono del cliente (o CANCELAR): ",
-                    nuevo.telefono, 20);
+    if (respuesta.tellp() > 0) {
+        string texto = respuesta.str();
+        agregarSalida(c, texto.data(), texto.size());
+        respuesta.str("");
+    }
 
-    if (strcmp(nuevo.telefono, "CANCELAR") == 0 || strcmp(nuevo.telefono, "0") == 0)
-        return;
+    memmove(c->entrada, c->entrada + inicio, c->usadoEntrada - inicio);
+    c->usadoEntrada -= inicio;
+}
 
-    // --- Direccin ---
-    solicitarString("Ingrese direccin del cliente (o CANCELAR): ",
-                    nuevo.direccion, 200);
+void leerConexion(ConexionServidor* c) {
+    ssize_t leidos = recv(c->fd, c->entrada + c->usadoEntrada,
+                          TAM_ENTRADA_CONEXION - c->usadoEntrada, 0);
+    if (leidos > 0) {
+        c->usadoEntrada += (int)leidos;
+    } else if (leidos == 0) {
+        c->cerrar = true;      // el cliente termin de enviar; se contesta lo recibido
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        c->cerrar = true;
+        c->usadoEntrada = 0;
+        c->enviadoSalida = c->usadoSalida;
+    }
+}
 
-    if (strcmp(nuevo.direccion, "CANCELAR") == 0 || strcmp(nuevo.direccion, "0") == 0)
-        return;
+void enviarConexion(ConexionServidor* c) {
+    while (salidaPendiente(c) > 0) {
+        ssize_t enviados = send(c->fd, c->salida + c->enviadoSalida, (size_t)salidaPendiente(c),
+                                MSG_NOSIGNAL);
+        if (enviados > 0) {
+            c->enviadoSalida += enviados;
+        } else if (enviados < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                // El cliente ya no est: se descarta lo que quedaba
+                c->cerrar = true;
+                c->usadoEntrada = 0;
+                c->enviadoSalida = c->usadoSalida;
+            }
+            break;
+        }
+    }
+    if (salidaPendiente(c) == 0) {
+        c->usadoSalida = 0;
+        c->enviadoSalida = 0;
+    }
+}
 
-    // --- Fecha automtica ---
-    obtenerFechaActual(nuevo.fechaRegistro);
+// Lee mientras la salida no pase del lmite; espera poder escribir si hay
+// salida pendiente o lneas que se dejaron para despus
+void actualizarEventos(int epfd, ConexionServidor* c) {
+    unsigned int eventos = 0;
+    if (!c->cerrar && salidaPendiente(c) < LIMITE_SALIDA_CONEXION)
+        eventos |= EPOLLIN;
+    if (salidaPendiente(c) > 0 || c->lineasPendientes)
+        eventos |= EPOLLOUT;
+    if (eventos == c->eventos)
+        return;
 
-    // --- Resumen ---
-    cout << "\n=== RESUMEN DEL CLIENTE ===\n";
-    cout << "Cdula/RIF: " << nuevo.cedula << endl;
-    cout << "Nombre: " << nuevo.nombre << endl;
-    cout << "Email: " << nuevo.email << endl;
-    cout << "Telfono: " << nuevo.telefono << endl;
-    cout << "Direccin: " << nuevo.direccion << endl;
+    epoll_event ev;
+    ev.events = eventos;
+    ev.data.ptr = c;
+    epoll_ctl(epfd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->eventos = eventos;
+}
 
-    if (!confirmar("Guardar cliente? (S/N): "))
-        return;
+// Conexiones abiertas, indexadas por descriptor
+struct RegistroConexiones {
+    ConexionServidor** porFd;
+    int capacidad;
+    int num;
+};
 
-    // --- Redimensionar si es necesario ---
-    if (tienda->numClientes >= tienda->capacidadClientes)
-        redimensionarClientes(tienda);
+void aceptarConexiones(int escucha, int epfd, RegistroConexiones* registro) {
+    while (true) {
+        int fd = accept4(escucha, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                cerr << "ERROR: accept: " << strerror(errno) << "\n";
+            return;
+        }
 
-    // --- Guardar ---
-    nuevo.id = tienda->siguienteIdCliente++;
-    tienda->clientes[tienda->numClientes++] = nuevo;
+        // Solo tiene efecto en TCP
+        int uno = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &uno, sizeof(uno));
+
+        if (fd >= registro->capacidad) {
+            int nuevaCap = max(registro->capacidad * 2, 1024);
+            while (nuevaCap <= fd) nuevaCap *= 2;
+            ConexionServidor** nuevo = new ConexionServidor*[nuevaCap];
+            for (int i = 0; i < nuevaCap; i++)
+                nuevo[i] = i < registro->capacidad ? registro->porFd[i] : nullptr;
+            delete[] registro->porFd;
+            registro->porFd = nuevo;
+            registro->capacidad = nuevaCap;
+        }
 
-    cout << "Cliente registrado exitosamente.\n";
+        ConexionServidor* c = nuevaConexion(fd);
+        epoll_event ev;
+        ev.events = c->eventos;
+        ev.data.ptr = c;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            liberarConexion(c);
+            continue;
+        }
+        registro->porFd[fd] = c;
+        registro->num++;
+    }
 }
 
-//2.4.2
+void cerrarConexion(int epfd, RegistroConexiones* registro, ConexionServidor* c) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, nullptr);
+    registro->porFd[c->fd] = nullptr;
+    registro->num--;
+    liberarConexion(c);
+}
 
-void buscarCliente(Tienda* tienda) {
-    int opcion;
+bool esPuerto(const char* texto) {
+    int puerto;
+    return leerEnteroCsv(texto, &puerto) && puerto > 0 && puerto <= 65535;
+}
 
-    do {
-        cout << "\n=== BUSCAR CLIENTE ===\n";
-        cout << "1. Buscar por ID\n";
-        cout << "2. Buscar por nombre (coincidencia parcial)\n";
-        cout << "3. Buscar por cdula/RIF\n";
-        cout << "0. Cancelar\n";
-        cout << "Seleccione una opcin: ";
-        cin >> opcion;
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+// Socket de escucha no bloqueante; -1 si no se pudo abrir
+int abrirSocketServidor(const char* direccion) {
+    int fd;
+    int ok;
+    if (esPuerto(direccion)) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        int uno = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &uno, sizeof(uno));
+
+        sockaddr_in dir;
+        memset(&dir, 0, sizeof(dir));
+        dir.sin_family = AF_INET;
+        dir.sin_port = htons((unsigned short)atoi(direccion));
+        dir.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ok = bind(fd, (sockaddr*)&dir, sizeof(dir));
+    } else {
+        sockaddr_un dir;
+        memset(&dir, 0, sizeof(dir));
+        dir.sun_family = AF_UNIX;
+        if (strlen(direccion) >= sizeof(dir.sun_path)) {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        strcpy(dir.sun_path, direccion);
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        // Un socket viejo de una ejecucin anterior impedira el bind
+        struct stat info;
+        if (stat(direccion, &info) == 0 && S_ISSOCK(info.st_mode))
+            unlink(direccion);
+        ok = bind(fd, (sockaddr*)&dir, sizeof(dir));
+    }
 
-        if (opcion == 0)
-            return;
+    if (ok != 0 || listen(fd, SOMAXCONN) != 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
 
-        int index = -1;
+int ejecutarServidor(Tienda* tienda, const char* direccion) {
+    int escucha = abrirSocketServidor(direccion);
+    if (escucha < 0) {
+        cout << "ERROR: No se pudo escuchar en '" << direccion << "': " << strerror(errno) << ".\n";
+        return 1;
+    }
 
-        switch (opcion) {
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;     // nullptr = socket de escucha
+    epoll_ctl(epfd, EPOLL_CTL_ADD, escucha, &ev);
+
+    struct sigaction accion;
+    memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = detenerServidor;
+    sigaction(SIGINT, &accion, nullptr);
+    sigaction(SIGTERM, &accion, nullptr);
+
+    cout << "Servidor escuchando en " << (esPuerto(direccion) ? "127.0.0.1:" : "") << direccion << endl;
+
+    RegistroConexiones registro;
+    registro.porFd = nullptr;
+    registro.capacidad = 0;
+    registro.num = 0;
+
+    epoll_event* eventos = new epoll_event[MAX_EVENTOS_SERVIDOR];
+    ConexionServidor** vuelta = new ConexionServidor*[MAX_EVENTOS_SERVIDOR];
+    ostringstream respuesta;
+
+    while (!servidorDetenido) {
+        int n = epoll_wait(epfd, eventos, MAX_EVENTOS_SERVIDOR, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            cout << "ERROR: epoll_wait: " << strerror(errno) << ".\n";
+            break;
+        }
 
-            case 1: {
-                int id;
-                cout << "Ingrese ID del cliente: ";
-                cin >> id;
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        long long lsnInicial = tienda->lsn;
+        int hoy = fechaActual();
+        int numVuelta = 0;
 
-                index = buscarClientePorID(tienda, id);
-                break;
+        // Leer y ejecutar; las respuestas se acumulan
+        for (int i = 0; i < n; i++) {
+            ConexionServidor* c = (ConexionServidor*)eventos[i].data.ptr;
+            if (c == nullptr) {
+                aceptarConexiones(escucha, epfd, &registro);
+                continue;
             }
 
-            case 2: {
-                char nombre[100];
-                solicitarString("Ingrese nombre o parte del nombre: ", nombre, 100);
-                index = buscarClientePorNombre(tienda, nombre);
-                break;
-            }
+            if (eventos[i].events & EPOLLIN)
+                leerConexion(c);
+            else if (eventos[i].events & (EPOLLERR | EPOLLHUP))
+                c->cerrar = true;
+            procesarEntrada(tienda, c, respuesta, hoy);
 
-            case 3: {
-                char cedula[20];
-                solicitarString("Ingrese cdula/RIF del cliente: ", cedula, 20);
-                index = buscarClientePorCedula(tienda, cedula);
-                break;
+            if (!c->enVuelta) {
+                c->enVuelta = true;
+                vuelta[numVuelta++] = c;
             }
-
-            default:
-                cout << "Opcin invlida.\n";
-                continue;
         }
 
-        if (index == -1) {
-            cout << "No se encontr ningn cliente con ese criterio.\n";
-        } else {
-            mostrarCliente(tienda->clientes[index]);
+        // Una sola espera por el disco para todos los cambios de la vuelta
+        if (tienda->lsn != lsnInicial)
+            confirmarCambios(tienda);
+
+        for (int i = 0; i < numVuelta; i++) {
+            ConexionServidor* c = vuelta[i];
+            c->enVuelta = false;
+            enviarConexion(c);
+            if (c->cerrar && salidaPendiente(c) == 0 && !c->lineasPendientes)
+                cerrarConexion(epfd, &registro, c);
+            else
+                actualizarEventos(epfd, c);
         }
+    }
 
-        system("pause");
-
-    } while (opcion != 0);
+    cout << "Servidor detenido (" << registro.num << " conexiones abiertas).\n";
+    for (int fd = 0; fd < registro.capacidad; fd++) {
+        if (registro.porFd[fd] != nullptr)
+            liberarConexion(registro.porFd[fd]);
+    }
+    delete[] registro.porFd;
+    delete[] eventos;
+    delete[] vuelta;
+    close(epfd);
+    close(escucha);
+    if (!esPuerto(direccion))
+        unlink(direccion);
+    return 0;
 }
 
-//2.4.3
-
-void actualizarCliente(Tienda* tienda) {
-    int id;
-    cout << "Ingrese el ID del cliente a actualizar (0 para cancelar): ";
-    cin >> id;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
-    if (id == 0)
-        return;
+#else
 
-    int index = buscarClientePorID(tienda, id);
-    if (index == -1) {
-        cout << "ERROR: No existe un cliente con ese ID.\n";
-        return;
-    }
+int ejecutarServidor(Tienda*, const char*) {
+    cout << "ERROR: El modo servidor necesita epoll (Linux).\n";
+    return 1;
+}
 
-    Cliente& original = tienda->clientes[index];
-    Cliente temp = original; // copia temporal
+#endif
 
-    cout << "\n=== CLIENTE ENCONTRADO ===\n";
-    mostrarCliente(original);
+//======================
+//3.7 cadena de sucursales
+//======================
 
-    if (!confirmar("\nDesea modificar este cliente? (S/N): "))
-        return;
+// Una cadena rene varias tiendas (sucursales), cada una con sus tablas, sus
+// contadores de id y sus propios archivos <ruta>.dat y <ruta>.wal, que se
+// cargan y guardan por separado. Las operaciones de una sucursal se hacen
+// sobre su Tienda; las consultas de toda la cadena se reparten entre un pool
+// de hilos, una sucursal por tarea, y se combinan al final en orden de
+// sucursal. Cada sucursal la toca un solo hilo a la vez, as que los ndices
+// que arma la primera consulta no necesitan cerrojo.
+
+// Hilos fijos que reparten entre s las tareas de una ronda; quien la lanza
+// tambin trabaja, as que con un solo ncleo no hay hilos extra
+struct PoolHilos {
+    thread* hilos;
+    int num;
+    mutex m;
+    condition_variable hayTrabajo;
+    condition_variable terminado;
+    function<void(int)> tarea;
+    int siguiente;             // prxima tarea sin tomar
+    int total;
+    int trabajando;            // hilos con una tarea de esta ronda en curso
+    long long ronda;
+    bool salir;
+};
 
-    // --- Nombre ---
-    cout << "\nNombre actual: " << temp.nombre << endl;
-    solicitarString("Nuevo nombre (ENTER para mantener): ", temp.nombre, 100);
-    if (strlen(temp.nombre) == 0)
-        strcpy(temp.nombre, original.nombre);
+// Toma tareas de la ronda mientras queden; se llama con el mutex tomado
+void tomarTareas(PoolHilos* pool, unique_lock<mutex>& lock) {
+    pool->trabajando++;
+    while (pool->siguiente < pool->total) {
+        int i = pool->siguiente++;
+        lock.unlock();
+        pool->tarea(i);
+        lock.lock();
+    }
+    if (--pool->trabajando == 0)
+        pool->terminado.notify_all();
+}
 
-    // --- Cdula/RIF ---
-    cout << "\nCdula/RIF actual: " << temp.cedula << endl;
-    solicitarString("Nueva cdula/RIF (ENTER para mantener): ", temp.cedula, 20);
-    if (strlen(temp.cedula) == 0)
-        strcpy(temp.cedula, original.cedula);
-    else if (clienteDuplicado(tienda, temp.cedula, original.id)) {
-        cout << "ERROR: La cdula/RIF '" << temp.cedula << "' ya est registrada.\n";
-        return;
+void trabajarEnPool(PoolHilos* pool) {
+    long long vista = 0;
+    unique_lock<mutex> lock(pool->m);
+    while (true) {
+        pool->hayTrabajo.wait(lock, [&] { return pool->salir || pool->ronda != vista; });
+        if (pool->salir)
+            return;
+        vista = pool->ronda;
+        tomarTareas(pool, lock);
     }
+}
 
-    // --- Telfono ---
-    cout << "\nTelfono actual: " << temp.telefono << endl;
-    solicitarString("Nuevo telfono (ENTER para mantener): ", temp.telefono, 20);
-    if (strlen(temp.telefono) == 0)
-        strcpy(temp.telefono, original.telefono);
+void iniciarPool(PoolHilos* pool) {
+    int numHilos = thread::hardware_concurrency();
+    if (numHilos < 1) numHilos = 1;
+    if (numHilos > 16) numHilos = 16;
+
+    pool->num = numHilos - 1;
+    pool->siguiente = 0;
+    pool->total = 0;
+    pool->trabajando = 0;
+    pool->ronda = 0;
+    pool->salir = false;
+    pool->hilos = new thread[max(pool->num, 1)];
+    for (int h = 0; h < pool->num; h++)
+        pool->hilos[h] = thread(trabajarEnPool, pool);
+}
 
-    // --- Email ---
-    cout << "\nEmail actual: " << temp.email << endl;
-    solicitarString("Nuevo email (ENTER para mantener): ", temp.email, 100);
-    if (strlen(temp.email) == 0)
-        strcpy(temp.email, original.email);
-    else if (!emailValido(temp.email)) {
-        cout << "ERROR: El email debe contener '@' y un dominio.\n";
-        return;
+void liberarPool(PoolHilos* pool) {
+    {
+        lock_guard<mutex> lock(pool->m);
+        pool->salir = true;
     }
+    pool->hayTrabajo.notify_all();
+    for (int h = 0; h < pool->num; h++)
+        pool->hilos[h].join();
+    delete[] pool->hilos;
+    pool->hilos = nullptr;
+    pool->num = 0;
+}
 
-    // --- Direccin ---
-    cout << "\nDireccin actual: " << temp.direccion << endl;
-    solicitarString("Nueva direccin (ENTER para mantener): ", temp.direccion, 200);
-    if (strlen(temp.direccion) == 0)
-        strcpy(temp.direccion, original.direccion);
+// tarea(i) para i en [0, total), repartido entre los hilos; vuelve cuando
+// terminaron todas. No es reentrante.
+void ejecutarEnPool(PoolHilos* pool, int total, function<void(int)> tarea) {
+    unique_lock<mutex> lock(pool->m);
+    pool->tarea = tarea;
+    pool->siguiente = 0;
+    pool->total = total;
+    pool->ronda++;
+    if (pool->num > 0 && total > 1)
+        pool->hayTrabajo.notify_all();
+
+    tomarTareas(pool, lock);
+    pool->terminado.wait(lock, [pool] { return pool->trabajando == 0; });
+    pool->tarea = nullptr;
+}
 
-    // --- Confirmacin final ---
-    cout << "\n=== NUEVOS DATOS DEL CLIENTE ===\n";
-    mostrarCliente(temp);
+const int LARGO_RUTA_SUCURSAL = 260;
 
-    if (!confirmar("Guardar cambios? (S/N): "))
-        return;
+struct Sucursal {
+    Tienda tienda;
+    char ruta[LARGO_RUTA_SUCURSAL];            // prefijo de los archivos
+    char rutaSnapshot[LARGO_RUTA_SUCURSAL + 4];
+    char rutaWal[LARGO_RUTA_SUCURSAL + 4];
+};
 
-    original = temp;
+struct Cadena {
+    Sucursal** sucursales;     // cada Tienda queda fija al crecer el arreglo
+    int num;
+    int capacidad;
+    PoolHilos pool;
+};
 
-    cout << "Cliente actualizado exitosamente.\n";
+void iniciarCadena(Cadena* cadena) {
+    cadena->sucursales = nullptr;
+    cadena->num = 0;
+    cadena->capacidad = 0;
+    iniciarPool(&cadena->pool);
 }
 
-//2.4.4
+// Abre la sucursal de <ruta>.dat y <ruta>.wal (vaca si no existen) y la
+// agrega al final. Devuelve su posicin, o -1 si la ruta no sirve o sus
+// archivos no se pueden leer.
+int agregarSucursal(Cadena* cadena, const char* ruta) {
+    if (strlen(ruta) == 0 || strlen(ruta) >= LARGO_RUTA_SUCURSAL) {
+        cout << "ERROR: Ruta de sucursal invlida '" << ruta << "'.\n";
+        return -1;
+    }
 
-void listarClientes(Tienda* tienda) {
-    if (tienda->numClientes == 0) {
-        cout << "No hay clientes registrados.\n";
-        return;
+    if (cadena->num == cadena->capacidad) {
+        int nuevaCap = max(cadena->capacidad * 2, 4);
+        Sucursal** nuevo = new Sucursal*[nuevaCap];
+        for (int i = 0; i < cadena->num; i++)
+            nuevo[i] = cadena->sucursales[i];
+        delete[] cadena->sucursales;
+        cadena->sucursales = nuevo;
+        cadena->capacidad = nuevaCap;
     }
 
-    encabezadoClientes();
+    Sucursal* s = new Sucursal;
+    strcpy(s->ruta, ruta);
+    snprintf(s->rutaSnapshot, sizeof(s->rutaSnapshot), "%s.dat", ruta);
+    snprintf(s->rutaWal, sizeof(s->rutaWal), "%s.wal", ruta);
 
-    for (int i = 0; i < tienda->numClientes; i++) {
-        filaCliente(tienda->clientes[i]);
+    if (!abrirTienda(&s->tienda, s->rutaSnapshot, s->rutaWal)) {
+        delete s;
+        return -1;
     }
 
-    pieClientes();
+    cadena->sucursales[cadena->num] = s;
+    return cadena->num++;
+}
 
-    cout << "\nTotal de clientes: " << tienda->numClientes << "\n";
+// Tienda de la sucursal 'numero' (desde 1), o nullptr si no existe
+Tienda* tiendaDeSucursal(Cadena* cadena, int numero) {
+    if (numero < 1 || numero > cadena->num)
+        return nullptr;
+    return &cadena->sucursales[numero - 1]->tienda;
 }
 
-//2.4.5
+bool guardarSucursal(Cadena* cadena, int numero) {
+    Tienda* tienda = tiendaDeSucursal(cadena, numero);
+    return tienda != nullptr && guardarSnapshot(tienda, cadena->sucursales[numero - 1]->rutaSnapshot);
+}
 
-void eliminarCliente(Tienda* tienda) {
-    int id;
-    cout << "Ingrese el ID del cliente a eliminar (0 para cancelar): ";
-    cin >> id;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+// Espera el fsync del WAL de cada sucursal
+bool confirmarCambiosCadena(Cadena* cadena) {
+    bool ok = true;
+    for (int i = 0; i < cadena->num; i++)
+        ok = confirmarCambios(&cadena->sucursales[i]->tienda) && ok;
+    return ok;
+}
 
-    if (id == 0)
-        return;
+void liberarCadena(Cadena* cadena) {
+    liberarPool(&cadena->pool);
+    for (int i = 0; i < cadena->num; i++) {
+        Sucursal* s = cadena->sucursales[i];
+        if (s->tienda.wal != nullptr)
+            cerrarRegistroCambios(s->tienda.wal);
+        liberarTienda(&s->tienda);
+        delete s;
+    }
+    delete[] cadena->sucursales;
+    cadena->sucursales = nullptr;
+    cadena->num = 0;
+    cadena->capacidad = 0;
+}
 
-    int index = buscarClientePorID(tienda, id);
-    if (index == -1) {
-        cout << "ERROR: No existe un cliente con ese ID.\n";
-        return;
+// f(posicion, tienda) para cada sucursal, en paralelo
+template <typename F>
+void enCadaSucursal(Cadena* cadena, F f) {
+    ejecutarEnPool(&cadena->pool, cadena->num, [cadena, &f](int i) {
+        f(i, &cadena->sucursales[i]->tienda);
+    });
+}
+
+// Dnde hay stock de un producto, por su cdigo
+struct ExistenciaSucursal {
+    int sucursal;              // nmero, desde 1
+    int idProducto;
+    int stock;
+};
+
+ExistenciaSucursal* existenciasEnCadena(Cadena* cadena, const char* codigo, int* numResultados) {
+    ExistenciaSucursal* porSucursal = new ExistenciaSucursal[max(cadena->num, 1)];
+    enCadaSucursal(cadena, [&](int i, Tienda* tienda) {
+        ExistenciaSucursal& e = porSucursal[i];
+        e.sucursal = i + 1;
+        e.idProducto = idPorCodigo(tienda, codigo);
+        int index = e.idProducto == -1 ? -1 : buscarProductoPorID(tienda, e.idProducto);
+        e.stock = index == -1 ? 0 : tienda->productos[index].stock;
+    });
+
+    int num = 0;
+    for (int i = 0; i < cadena->num; i++) {
+        if (porSucursal[i].stock > 0)
+            porSucursal[num++] = porSucursal[i];
     }
+    *numResultados = num;
+    return porSucursal;
+}
 
-    Cliente& c = tienda->clientes[index];
+// Totales de inventario de toda la cadena; si porSucursal no es nullptr
+// recibe adems los de cada sucursal
+TotalesInventario valorDeCadena(Cadena* cadena, TotalesInventario* porSucursal) {
+    TotalesInventario* totales = porSucursal != nullptr ? porSucursal
+                                                        : new TotalesInventario[max(cadena->num, 1)];
+    enCadaSucursal(cadena, [&](int i, Tienda* tienda) {
+        totales[i] = agregadosDeInventario(tienda)->global;
+    });
+
+    TotalesInventario cadenaTotal = { 0, 0, 0 };
+    for (int i = 0; i < cadena->num; i++) {
+        cadenaTotal.productos += totales[i].productos;
+        cadenaTotal.unidades += totales[i].unidades;
+        cadenaTotal.valorCentavos += totales[i].valorCentavos;
+    }
+    if (porSucursal == nullptr)
+        delete[] totales;
+    return cadenaTotal;
+}
 
-    cout << "\n=== CLIENTE A ELIMINAR ===\n";
-    mostrarCliente(c);
+// Un cliente puede estar registrado en varias sucursales
+struct ClienteSucursal {
+    int sucursal;              // nmero, desde 1
+    Cliente cliente;
+};
 
-    // Verificar transacciones asociadas
-    bool tieneTransacciones = false;
-    for (int i = 0; i < tienda->numTransacciones; i++) {
-        if (tienda->transacciones[i].idRelacionado == id &&
-            strcmp(tienda->transacciones[i].tipo, "VENTA") == 0) {
-            tieneTransacciones = true;
-            break;
+ClienteSucursal* clienteEnCadena(Cadena* cadena, const char* cedula, int* numResultados) {
+    ClienteSucursal* porSucursal = new ClienteSucursal[max(cadena->num, 1)];
+    enCadaSucursal(cadena, [&](int i, Tienda* tienda) {
+        int index = buscarClientePorCedula(tienda, cedula);
+        porSucursal[i].sucursal = index == -1 ? 0 : i + 1;
+        if (index != -1)
+            porSucursal[i].cliente = tienda->clientes[index];
+    });
+
+    int num = 0;
+    for (int i = 0; i < cadena->num; i++) {
+        if (porSucursal[i].sucursal != 0)
+            porSucursal[num++] = porSucursal[i];
+    }
+    *numResultados = num;
+    return porSucursal;
+}
+
+// inventario --cadena ruta1 [ruta2 ...]
+//
+// Abre cada ruta como una sucursal (numeradas desde 1 en el orden dado) y lee
+// operaciones de la entrada estndar con el formato del modo por lotes:
+//
+//   en,sucursal,<operacin del modo por lotes>
+//   existencias,codigo          sucursal,idProducto,stock por cada una con stock
+//   valor                       sucursal,productos,unidades,valor por cada una
+//   cliente,cedula              sucursal,<cliente> por cada una donde est
+//   guardar                     guarda todas las sucursales
+//
+// Las tres consultas recorren todas las sucursales en paralelo. 'en,n,guardar'
+// guarda solo esa sucursal, en su propio archivo.
+bool comandoCadena(Cadena* cadena, ostream& salida, char** campos, int n, int hoy, char* motivo) {
+    const char* comando = campos[0];
+
+    if (strcmp(comando, "en") == 0) {
+        int numero;
+        Tienda* tienda = nullptr;
+        if (n >= 3 && leerEnteroCsv(campos[1], &numero))
+            tienda = tiendaDeSucursal(cadena, numero);
+        if (tienda == nullptr) {
+            snprintf(motivo, 100, "Uso: en,sucursal(1-%d),operacin", cadena->num);
+            return false;
+        }
+
+        if (strcmp(campos[2], "guardar") == 0 && n == 3) {
+            if (!guardarSucursal(cadena, numero)) {
+                snprintf(motivo, 100, "No se pudo guardar %.80s",
+                         cadena->sucursales[numero - 1]->rutaSnapshot);
+                return false;
+            }
+            salida << "OK\n";
+            return true;
         }
+        return ejecutarComando(tienda, salida, campos + 2, n - 2, hoy, motivo);
     }
 
-    if (tieneTransacciones) {
-        cout << "\nADVERTENCIA: Este cliente tiene transacciones asociadas.\n";
-        cout << "No se puede eliminar mientras existan ventas registradas.\n";
-        return;
+    if (strcmp(comando, "existencias") == 0 && n == 2) {
+        int num;
+        ExistenciaSucursal* existencias = existenciasEnCadena(cadena, campos[1], &num);
+        long long total = 0;
+        for (int i = 0; i < num; i++) {
+            salida << existencias[i].sucursal << ',' << existencias[i].idProducto << ','
+                   << existencias[i].stock << '\n';
+            total += existencias[i].stock;
+        }
+        delete[] existencias;
+        salida << "OK " << num << ',' << total << '\n';
+        return true;
     }
 
-    if (!confirmar("\nEliminar cliente? (S/N): ")) {
-        cout << "Eliminacin cancelada.\n";
-        return;
+    if (strcmp(comando, "valor") == 0 && n == 1) {
+        TotalesInventario* porSucursal = new TotalesInventario[max(cadena->num, 1)];
+        TotalesInventario total = valorDeCadena(cadena, porSucursal);
+        for (int i = 0; i < cadena->num; i++) {
+            salida << i + 1 << ',' << porSucursal[i].productos << ',' << porSucursal[i].unidades << ',';
+            escribirCentavosCsv(salida, porSucursal[i].valorCentavos);
+            salida << '\n';
+        }
+        delete[] porSucursal;
+        salida << "OK " << total.productos << ',' << total.unidades << ',';
+        escribirCentavosCsv(salida, total.valorCentavos);
+        salida << '\n';
+        return true;
     }
 
-    // Eliminar moviendo elementos
-    for (int i = index; i < tienda->numClientes - 1; i++) {
-        tienda->clientes[i] = tienda->clientes[i + 1];
+    if (strcmp(comando, "cliente") == 0 && n == 2) {
+        int num;
+        ClienteSucursal* clientes = clienteEnCadena(cadena, campos[1], &num);
+        for (int i = 0; i < num; i++) {
+            salida << clientes[i].sucursal << ',';
+            escribirClienteCsv(salida, clientes[i].cliente);
+        }
+        delete[] clientes;
+        salida << "OK " << num << '\n';
+        return true;
     }
 
-    tienda->numClientes--;
+    if (strcmp(comando, "guardar") == 0 && n == 1) {
+        for (int i = 1; i <= cadena->num; i++) {
+            if (!guardarSucursal(cadena, i)) {
+                snprintf(motivo, 100, "No se pudo guardar %.80s", cadena->sucursales[i - 1]->rutaSnapshot);
+                return false;
+            }
+        }
+        salida << "OK\n";
+        return true;
+    }
 
-    cout << "Cliente eliminado exitosamente.\n";
+    snprintf(motivo, 100, "Comando desconocido '%.40s'", comando);
+    return false;
 }
 
+int ejecutarCadena(int argc, char* argv[]) {
+    Cadena cadena;
+    iniciarCadena(&cadena);
+
+    bool ok = true;
+    for (int i = 2; i < argc && ok; i++)
+        ok = agregarSucursal(&cadena, argv[i]) != -1;
+
+    long long errores = 0;
+    if (ok) {
+        errores = leerComandos(nullptr, [&cadena](char** campos, int n, int hoy, char* motivo) {
+            return comandoCadena(&cadena, cout, campos, n, hoy, motivo);
+        });
+        if (!confirmarCambiosCadena(&cadena))
+            errores++;
+        cout.flush();
+    }
 
-//main temporal
+    liberarCadena(&cadena);
+    return ok && errores == 0 ? 0 : 1;
+}
 
-int main() {
+int main(int argc, char* argv[]) {
     setlocale(LC_ALL, "Spanish");
 
+    // inventario --bench [n1 n2 ...] (no carga ni modifica los datos)
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0)
+        return ejecutarBench(argc, argv);
+
+    // inventario --cadena ruta1 [ruta2 ...] (no usa tienda.dat)
+    if (argc >= 3 && strcmp(argv[1], "--cadena") == 0) {
+        ios::sync_with_stdio(false);
+        return ejecutarCadena(argc, argv);
+    }
+
     Tienda tienda;
 
-    // Inicializacin bsica
-    tienda.numProductos = 0;
-    tienda.capacidadProductos = 10;
-    tienda.productos = new Producto[tienda.capacidadProductos];
-    tienda.siguienteIdProducto = 1;
+    if (!abrirTienda(&tienda, ARCHIVO_SNAPSHOT, ARCHIVO_WAL))
+        return 1;
+
+    // inventario --importar productos|proveedores|clientes archivo.csv
+    if (argc == 4 && strcmp(argv[1], "--importar") == 0) {
+        int entidad = -1;
+        if (strcmp(argv[2], "productos") == 0) entidad = ENTIDAD_PRODUCTO;
+        else if (strcmp(argv[2], "proveedores") == 0) entidad = ENTIDAD_PROVEEDOR;
+        else if (strcmp(argv[2], "clientes") == 0) entidad = ENTIDAD_CLIENTE;
+
+        bool ok = false;
+        if (entidad == -1)
+            cout << "ERROR: Entidad desconocida '" << argv[2] << "'.\n";
+        else
+            ok = importarCsv(&tienda, entidad, argv[3]);
+
+        if (tienda.wal != nullptr)
+            cerrarRegistroCambios(tienda.wal);
+        liberarTienda(&tienda);
+        return ok ? 0 : 1;
+    }
+
+    if ((argc == 2 || argc == 3) && strcmp(argv[1], "--comandos") == 0) {
+        ios::sync_with_stdio(false);
+        long long errores = ejecutarComandos(&tienda, argc == 3 ? argv[2] : nullptr);
 
-    tienda.numProveedores = 0;
-    tienda.capacidadProveedores = 10;
-    tienda.proveedores = new Proveedor[tienda.capacidadProveedores];
-    tienda.siguienteIdProveedor = 1;
+        if (tienda.wal != nullptr)
+            cerrarRegistroCambios(tienda.wal);
+        liberarTienda(&tienda);
+        return errores == 0 ? 0 : 1;
+    }
 
-    tienda.numClientes = 0;
-    tienda.capacidadClientes = 10;
-    tienda.clientes = new Cliente[tienda.capacidadClientes];
-    tienda.siguienteIdCliente = 1;
+    // inventario --servidor <puerto|ruta>
+    if (argc == 3 && strcmp(argv[1], "--servidor") == 0) {
+        ios::sync_with_stdio(false);
+        int resultado = ejecutarServidor(&tienda, argv[2]);
 
-    tienda.numTransacciones = 0;
-    tienda.capacidadTransacciones = 10;
-    tienda.transacciones = new Transaccion[tienda.capacidadTransacciones];
-    tienda.siguienteIdTransaccion = 1;
+        if (tienda.wal != nullptr)
+            cerrarRegistroCambios(tienda.wal);
+        liberarTienda(&tienda);
+        return resultado;
+    }
 
     int opcion;
 
@@ -1620,6 +8818,18 @@ int main() {
 		cout<< "15. Eliminar cliente\n";
 		cout<< "16. Listar clientes\n";
 		cout << "-------------------------------\n";
+        cout << "17. Guardar datos\n";
+        cout << "18. Importar CSV\n";
+        cout << "19. Compactar tablas\n";
+        cout << "23. Exportar listado a archivo\n";
+        cout << "-------------------------------\n";
+        cout << "20. Registrar compra\n";
+        cout << "21. Registrar venta\n";
+        cout << "22. Listar transacciones\n";
+        cout << "24. Transacciones por rango de fechas\n";
+        cout << "25. Resumen de inventario\n";
+        cout << "26. Reportes de ventas\n";
+        cout << "27. Productos por reponer\n";
         cout << "0. Salir\n";
         cout << "Seleccione una opcin: ";
         cin >> opcion;
@@ -1648,6 +8858,26 @@ int main() {
 			case 14: actualizarCliente(&tienda); break; 
 			case 15: eliminarCliente(&tienda); break; 
 			case 16: listarClientes(&tienda); break;
+
+            case 17:
+                if (guardarSnapshot(&tienda, ARCHIVO_SNAPSHOT))
+                    cout << "Datos guardados en " << ARCHIVO_SNAPSHOT << ".\n";
+                break;
+            case 18: menuImportarCsv(&tienda); break;
+            case 19:
+                compactarTablas(&tienda);
+                cout << "Tablas compactadas.\n";
+                break;
+
+            // Transacciones
+            case 20: registrarTicket(&tienda, TICKET_COMPRA); break;
+            case 21: registrarTicket(&tienda, TICKET_VENTA); break;
+            case 22: listarTransacciones(&tienda); break;
+            case 23: exportarListado(&tienda); break;
+            case 24: transaccionesPorFecha(&tienda); break;
+            case 25: resumenInventario(&tienda); break;
+            case 26: reportesDeVentas(&tienda); break;
+            case 27: productosParaReponer(&tienda); break;
 			
             case 0:
                 cout << "Saliendo...\n";
@@ -1664,6 +8894,10 @@ int main() {
 
     } while (opcion != 0);
 
+    guardarSnapshot(&tienda, ARCHIVO_SNAPSHOT);
+    if (tienda.wal != nullptr)
+        cerrarRegistroCambios(tienda.wal);
+
     // Liberar memoria
     liberarTienda(&tienda);
 
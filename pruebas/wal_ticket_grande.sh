@@ -0,0 +1,44 @@
+#!/bin/sh
+# Una venta de 31 líneas (el máximo de un comando) se anota en el WAL como un
+# solo registro; al reiniciar tiene que recuperarse entera junto con lo que
+# se anotó después.
+#
+# Uso: pruebas/wal_ticket_grande.sh   (desde la raíz del repositorio)
+set -e
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+g++ -std=c++11 -O2 -pthread -o "$dir/inventario" inventario.cpp
+cd "$dir"
+
+{
+    echo "crear,proveedor,J-12345678,Proveedor,a@b.com,0212-5551234"
+    echo "crear,cliente,V-1234567,Cliente,a@b.com,0212-5551234,Caracas"
+    i=1
+    while [ $i -le 31 ]; do
+        echo "crear,producto,P$i,Producto $i,d,1,1.00,100"
+        i=$((i + 1))
+    done
+    venta="venta,1"
+    i=1
+    while [ $i -le 31 ]; do
+        venta="$venta,$i,$i"
+        i=$((i + 1))
+    done
+    echo "$venta"
+    echo "crear,producto,DESPUES,Creado tras la venta,d,1,1.00,5"
+} > escribir.txt
+
+printf 'buscar,producto,id,31\nbuscar,producto,codigo,DESPUES\n' > leer.txt
+
+./inventario --comandos escribir.txt > /dev/null
+./inventario --comandos leer.txt > salida.txt
+
+# Sin snapshot todo sale del WAL: 100 - 31 de stock y el producto posterior
+if grep -q '^31,P31,.*,69,' salida.txt && grep -q '^32,DESPUES,' salida.txt; then
+    echo "ok"
+else
+    echo "FALLO:"
+    cat salida.txt
+    exit 1
+fi